@@ -0,0 +1,219 @@
+#include "Commandlets/ISABakePlaneProfileCommandlet.h"
+
+#include "EngineUtils.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Utility/ISAPlaneProfile.h"
+#include "Utility/ISAPlaneProfileSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogISAPlaneProfile, Log, All);
+
+namespace
+{
+	//How far below a floor the search for the next layer starts, and how far it steps when it starts inside geometry
+	constexpr float LayerSeparation{5.f};
+	constexpr float SolidStep{20.f};
+	constexpr int32 MaxSolidSteps{64};
+
+	int8 QuantizeNormal(double Value)
+	{
+		return static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Value * 127.0), -127, 127));
+	}
+}
+
+UISABakePlaneProfileCommandlet::UISABakePlaneProfileCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UISABakePlaneProfileCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogISAPlaneProfile, Error, TEXT("Missing -Map=<long package name>"));
+		return 1;
+	}
+
+	FString AxisName{TEXT("X")};
+	float Spacing{10.f};
+	float Tolerance{50.f};
+
+	FParse::Value(*Params, TEXT("Axis="), AxisName);
+	FParse::Value(*Params, TEXT("Spacing="), Spacing);
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	UPackage* MapPackage{LoadPackage(nullptr, *MapName, LOAD_None)};
+	UWorld* World{MapPackage != nullptr ? UWorld::FindWorldInPackage(MapPackage) : nullptr};
+
+	if (!IsValid(World))
+	{
+		UE_LOG(LogISAPlaneProfile, Error, TEXT("Could not load map %s"), *MapName);
+		return 1;
+	}
+
+	//Only the collision is needed
+	World->WorldType = EWorldType::Editor;
+	World->AddToRoot();
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+
+	World->UpdateWorldComponents(true, false);
+
+	const FString ProfilePackageName{UISAPlaneProfileSubsystem::GetProfilePackageName(FPackageName::GetShortName(MapName))};
+	UPackage* ProfilePackage{CreatePackage(*ProfilePackageName)};
+	auto* Profile{NewObject<UISAPlaneProfile>(ProfilePackage, *FPackageName::GetShortName(ProfilePackageName), RF_Public | RF_Standalone)};
+
+	const FBox Bounds{ALevelBounds::CalculateLevelBounds(World->PersistentLevel)};
+	const FVector Axis{AxisName == TEXT("Y") ? FVector::RightVector : FVector::ForwardVector};
+	const float HalfLength{UE_REAL_TO_FLOAT(FVector::DotProduct(Bounds.GetExtent(), Axis))};
+
+	//The plane runs through the play space along the chosen axis: the given origin, else the first player start, else the level center
+	FVector PlaneOrigin{Bounds.GetCenter()};
+
+	if (FString OriginString; FParse::Value(*Params, TEXT("PlaneOrigin="), OriginString, false))
+	{
+		if (!PlaneOrigin.InitFromString(OriginString))
+		{
+			UE_LOG(LogISAPlaneProfile, Error, TEXT("Invalid -PlaneOrigin=%s, expected (X=...,Y=...,Z=...)"), *OriginString);
+			World->RemoveFromRoot();
+			return 1;
+		}
+	}
+	else if (const TActorIterator<APlayerStart> PlayerStart{World}; PlayerStart)
+	{
+		PlaneOrigin = PlayerStart->GetActorLocation();
+	}
+	else
+	{
+		UE_LOG(LogISAPlaneProfile, Warning, TEXT("%s has no player start, the plane runs through the level center"), *MapName);
+	}
+
+	float PlaneOffset{0.f};
+	FParse::Value(*Params, TEXT("PlaneOffset="), PlaneOffset);
+
+	//Moves the plane sideways, perpendicular to the axis
+	PlaneOrigin += FVector::CrossProduct(FVector::UpVector, Axis) * PlaneOffset;
+
+	const FVector Start{Bounds.GetCenter() - Axis * HalfLength};
+
+	Profile->Axis = Axis;
+	Profile->Origin = PlaneOrigin + Axis * FVector::DotProduct(Start - PlaneOrigin, Axis);
+	Profile->SampleSpacing = Spacing;
+	Profile->PlaneTolerance = Tolerance;
+
+	TArray<TArray<FISAPlaneProfileSample>> Columns;
+
+	BakeColumns(*World, *Profile, HalfLength * 2, UE_REAL_TO_FLOAT(Bounds.Max.Z) + 100.f, UE_REAL_TO_FLOAT(Bounds.Min.Z) - 100.f, Columns);
+
+	for (TArray<FISAPlaneProfileSample>& Column : Columns)
+	{
+		Column.Sort([](const FISAPlaneProfileSample& A, const FISAPlaneProfileSample& B) { return A.FloorZ < B.FloorZ; });
+		Profile->Samples.Append(Column);
+	}
+
+	UE_LOG(LogISAPlaneProfile, Display, TEXT("Baked %d samples for %s"), Profile->Samples.Num(), *MapName);
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+
+	const FString Filename{FPackageName::LongPackageNameToFilename(ProfilePackageName, FPackageName::GetAssetPackageExtension())};
+	const bool bSaved{UPackage::SavePackage(ProfilePackage, Profile, *Filename, SaveArgs)};
+
+	World->RemoveFromRoot();
+
+	if (!bSaved)
+	{
+		UE_LOG(LogISAPlaneProfile, Error, TEXT("Could not save %s"), *Filename);
+		return 1;
+	}
+
+	return 0;
+#else
+	UE_LOG(LogISAPlaneProfile, Error, TEXT("Plane profiles can only be baked in editor builds"));
+	return 1;
+#endif
+}
+
+void UISABakePlaneProfileCommandlet::BakeColumns(const UWorld& World, UISAPlaneProfile& Profile, float Length, float TopZ, float BottomZ,
+	TArray<TArray<FISAPlaneProfileSample>>& OutColumns)
+{
+	//Only static geometry can be baked, a pushed crate would leave a floor behind or a hole where it now stands
+	FCollisionQueryParams Params{SCENE_QUERY_STAT(ISABakePlaneProfile), true};
+
+	for (TActorIterator<AActor> Actor{&World}; Actor; ++Actor)
+	{
+		for (const UActorComponent* Component : Actor->GetComponents())
+		{
+			const auto* Primitive{Cast<UPrimitiveComponent>(Component)};
+
+			if (Primitive != nullptr && Primitive->Mobility != EComponentMobility::Static)
+			{
+				Params.AddIgnoredComponent(Primitive);
+			}
+		}
+	}
+
+	const int32 ColumnCount{FMath::FloorToInt(Length / Profile.SampleSpacing) + 1};
+
+	OutColumns.SetNum(ColumnCount);
+
+	for (int32 ColumnIndex = 0; ColumnIndex < ColumnCount; ColumnIndex++)
+	{
+		const float Coordinate{ColumnIndex * Profile.SampleSpacing};
+		const FVector Column{Profile.Origin + Profile.Axis * Coordinate};
+
+		float StartZ{TopZ};
+		int32 SolidSteps{0};
+
+		while (OutColumns[ColumnIndex].Num() < MaxLayers && StartZ > BottomZ && SolidSteps < MaxSolidSteps)
+		{
+			FHitResult FloorHit;
+
+			if (!World.LineTraceSingleByProfile(FloorHit, {Column.X, Column.Y, StartZ}, {Column.X, Column.Y, BottomZ}, ISAPlaneProfile::CollisionProfileName, Params))
+			{
+				break;
+			}
+
+			//Started inside the layer above, keep stepping down until the trace is out of it
+			if (FloorHit.bStartPenetrating)
+			{
+				StartZ -= SolidStep;
+				SolidSteps++;
+				continue;
+			}
+
+			const float FloorZ{UE_REAL_TO_FLOAT(FloorHit.ImpactPoint.Z)};
+
+			FISAPlaneProfileSample Sample;
+			Sample.Coordinate = Coordinate;
+			Sample.FloorZ = FloorZ;
+			Sample.NormalAlong = QuantizeNormal(FVector::DotProduct(FloorHit.ImpactNormal, Profile.Axis));
+			Sample.NormalUp = QuantizeNormal(FloorHit.ImpactNormal.Z);
+
+			OutColumns[ColumnIndex].Add(Sample);
+
+			StartZ = FloorZ - LayerSeparation;
+		}
+	}
+}
@@ -0,0 +1,307 @@
+#include "Commandlets/ISABenchmarkCommandlet.h"
+
+#include "ISACharacterMovementComponent.h"
+#include "ISAPlayerCharacter.h"
+#include "Commandlets/ISABenchmarkWorld.h"
+#include "Commandlets/ISAScriptedInput.h"
+#include "Components/CapsuleComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Interactibles/ISAPushableBase.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Utility/ISAProfiling.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogISABenchmark, Log, All);
+
+namespace
+{
+	//Lanes are laid out in rows along Y
+	constexpr int32 LanesPerRow{32};
+	constexpr float LaneSpacing{600.f};
+	constexpr float RowSpacing{5000.f};
+	constexpr float LaneWidth{500.f};
+	constexpr float FloorThickness{20.f};
+
+	//Along the lane, measured from its origin
+	constexpr float LedgeX{1200.f};
+	constexpr float LedgeHeight{100.f};
+	constexpr float LedgeDepth{60.f};
+	constexpr float JumpDistance{150.f};
+
+	constexpr float SlopeX{2000.f};
+	constexpr float SlopeLength{1500.f};
+	constexpr float SlopeAngle{15.f};
+
+	constexpr float CrateX{4000.f};
+	constexpr float CrateOffset{170.f};
+	constexpr float CrateSize{100.f};
+	constexpr float InteractDistance{50.f};
+	constexpr float PushDuration{2.f};
+
+	constexpr float LaneLength{4600.f};
+
+	//Characters that fell off their lane are put back
+	constexpr float FallResetDepth{-2000.f};
+
+	//What a character on the last significance tier may cost compared to one on the first, checked by -CompareTiers
+	constexpr double MaxBackgroundCostRatio{0.1};
+
+	float GetSlopeEndX()
+	{
+		return SlopeX + SlopeLength * FMath::Cos(FMath::DegreesToRadians(SlopeAngle));
+	}
+
+	float GetSlopeEndZ()
+	{
+		return -SlopeLength * FMath::Sin(FMath::DegreesToRadians(SlopeAngle));
+	}
+}
+
+UISABenchmarkCommandlet::UISABenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UISABenchmarkCommandlet::Main(const FString& Params)
+{
+#if ISA_WITH_PROFILING
+	int32 CharacterCount{100};
+	int32 FrameCount{600};
+	int32 WarmupFrameCount{60};
+	float FrameRate{60.f};
+	FString CharacterClassName{FISABenchmarkWorld::DefaultCharacterClass};
+	FString OutputFile{FPaths::ProjectSavedDir() / TEXT("Benchmarks/ISABenchmark.json")};
+
+	FParse::Value(*Params, TEXT("Characters="), CharacterCount);
+	FParse::Value(*Params, TEXT("Frames="), FrameCount);
+	FParse::Value(*Params, TEXT("WarmupFrames="), WarmupFrameCount);
+	FParse::Value(*Params, TEXT("FrameRate="), FrameRate);
+	FParse::Value(*Params, TEXT("CharacterClass="), CharacterClassName);
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	const bool bCompareTiers{FParse::Param(*Params, TEXT("CompareTiers"))};
+
+	UClass* CharacterClass{LoadClass<AISAPlayerCharacter>(nullptr, *CharacterClassName)};
+
+	if (CharacterClass == nullptr || CharacterCount <= 0 || FrameCount <= 0 || FrameRate <= 0.f)
+	{
+		UE_LOG(LogISABenchmark, Error, TEXT("Invalid arguments, check -CharacterClass=%s, -Characters, -Frames and -FrameRate"), *CharacterClassName);
+		return 1;
+	}
+
+	UWorld* World{FISABenchmarkWorld::Create(TEXT("ISABenchmark"))};
+	const FISABenchmarkWorld Builder{*World};
+
+	TArray<FLane> Lanes;
+	Lanes.SetNum(CharacterCount);
+
+	for (int32 LaneIndex = 0; LaneIndex < CharacterCount; LaneIndex++)
+	{
+		Lanes[LaneIndex].Origin = {LaneIndex / LanesPerRow * RowSpacing, LaneIndex % LanesPerRow * LaneSpacing, 0.f};
+
+		BuildLane(Builder, Lanes[LaneIndex]);
+	}
+
+	FISABenchmarkWorld::BeginPlay(*World);
+
+	for (FLane& Lane : Lanes)
+	{
+		Lane.Character = Builder.AddCharacter(*CharacterClass, Lane.Origin + FVector{100.f, 0.f, 0.f});
+	}
+
+	//Montage bundles and anim layers requested on BeginPlay, only the steady state is measured
+	FlushAsyncLoading();
+
+	const float DeltaTime{1.f / FrameRate};
+
+	//Seconds spent ticking the world, the input is fed outside of the measurement
+	auto RunFrames{[&Lanes, World, DeltaTime](int32 Count)
+	{
+		double Seconds{0.0};
+
+		for (int32 Frame = 0; Frame < Count; Frame++)
+		{
+			for (FLane& Lane : Lanes)
+			{
+				DriveLane(Lane, DeltaTime);
+			}
+
+			const double StartSeconds{FPlatformTime::Seconds()};
+
+			FISABenchmarkWorld::Tick(*World, DeltaTime);
+
+			Seconds += FPlatformTime::Seconds() - StartSeconds;
+		}
+
+		return Seconds;
+	}};
+
+	//Nothing provides a viewpoint here, the tiers are set directly. The first one updates everything at full rate
+	for (FLane& Lane : Lanes)
+	{
+		Lane.Character->UpdateSignificance(0.f);
+	}
+
+	RunFrames(WarmupFrameCount);
+
+	ISAProfiling::Reset();
+	ISAProfiling::bEnabled = true;
+
+	const double FrameSeconds{RunFrames(FrameCount)};
+
+	ISAProfiling::bEnabled = false;
+
+	const auto Report{MakeShared<FJsonObject>()};
+	Report->SetNumberField(TEXT("Characters"), CharacterCount);
+	Report->SetNumberField(TEXT("Frames"), FrameCount);
+	Report->SetNumberField(TEXT("DeltaTime"), DeltaTime);
+	Report->SetNumberField(TEXT("FrameMs"), FrameSeconds * 1000.0 / FrameCount);
+
+	const auto Timers{MakeShared<FJsonObject>()};
+
+	for (int32 TimerIndex = 0; TimerIndex < ISAProfiling::TimerCount; TimerIndex++)
+	{
+		const auto Timer{static_cast<ISAProfiling::ETimer>(TimerIndex)};
+		const double Seconds{ISAProfiling::GetTimerSeconds(Timer)};
+
+		const auto TimerReport{MakeShared<FJsonObject>()};
+		TimerReport->SetNumberField(TEXT("MsPerFrame"), Seconds * 1000.0 / FrameCount);
+		TimerReport->SetNumberField(TEXT("MsPerCharacterFrame"), Seconds * 1000.0 / FrameCount / CharacterCount);
+
+		Timers->SetObjectField(ISAProfiling::ToString(Timer), TimerReport);
+
+		UE_LOG(LogISABenchmark, Display, TEXT("%-12s %8.4f ms/frame %8.5f ms/character"), ISAProfiling::ToString(Timer),
+		       Seconds * 1000.0 / FrameCount, Seconds * 1000.0 / FrameCount / CharacterCount);
+	}
+
+	Report->SetObjectField(TEXT("Timers"), Timers);
+
+	bool bWithinBudget{true};
+
+	//The same lanes again with every character on the last tier. There is nothing else in the world, so the frame time is the character cost
+	if (bCompareTiers)
+	{
+		for (FLane& Lane : Lanes)
+		{
+			Lane.Character->UpdateSignificance(WORLD_MAX);
+		}
+
+		RunFrames(WarmupFrameCount);
+
+		const double BackgroundFrameSeconds{RunFrames(FrameCount)};
+		const double CostRatio{BackgroundFrameSeconds / FrameSeconds};
+
+		Report->SetNumberField(TEXT("BackgroundFrameMs"), BackgroundFrameSeconds * 1000.0 / FrameCount);
+		Report->SetNumberField(TEXT("BackgroundCostRatio"), CostRatio);
+
+		bWithinBudget = CostRatio <= MaxBackgroundCostRatio;
+
+		UE_LOG(LogISABenchmark, Display, TEXT("Last significance tier: %.3f ms/frame, %.1f%% of the first tier"), BackgroundFrameSeconds * 1000.0 / FrameCount, CostRatio * 100.0);
+
+		if (!bWithinBudget)
+		{
+			UE_LOG(LogISABenchmark, Error, TEXT("Characters on the last significance tier cost more than %.0f%% of the first tier"), MaxBackgroundCostRatio * 100.0);
+		}
+	}
+
+	FString Json;
+	FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&Json));
+
+	FISABenchmarkWorld::Destroy(World);
+
+	if (!FFileHelper::SaveStringToFile(Json, *OutputFile))
+	{
+		UE_LOG(LogISABenchmark, Error, TEXT("Could not write %s"), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogISABenchmark, Display, TEXT("%d characters, %.3f ms/frame, written to %s"), CharacterCount, FrameSeconds * 1000.0 / FrameCount, *OutputFile);
+
+	return bWithinBudget ? 0 : 1;
+#else
+	UE_LOG(LogISABenchmark, Error, TEXT("The ISA timers are compiled out of this build"));
+	return 1;
+#endif
+}
+
+void UISABenchmarkCommandlet::BuildLane(const FISABenchmarkWorld& Builder, FLane& Lane)
+{
+	const FVector& Origin{Lane.Origin};
+
+	Builder.AddBox(Origin + FVector{SlopeX / 2, 0.f, -FloorThickness}, {SlopeX, LaneWidth, FloorThickness});
+	Builder.AddBox(Origin + FVector{LedgeX + LedgeDepth / 2, 0.f, 0.f}, {LedgeDepth, LaneWidth, LedgeHeight});
+	Builder.AddSlope(Origin + FVector{SlopeX, 0.f, 0.f}, FVector::ForwardVector, SlopeLength, LaneWidth, SlopeAngle);
+
+	const float LowerFloorLength{LaneLength + 500.f - GetSlopeEndX()};
+
+	Builder.AddBox(Origin + FVector{GetSlopeEndX() + LowerFloorLength / 2, 0.f, GetSlopeEndZ() - FloorThickness}, {LowerFloorLength, LaneWidth, FloorThickness});
+
+	Lane.Crate = Builder.AddCrate(Origin + FVector{CrateX, CrateOffset, GetSlopeEndZ()}, CrateSize);
+}
+
+void UISABenchmarkCommandlet::DriveLane(FLane& Lane, float DeltaTime)
+{
+	AISAPlayerCharacter& Character{*Lane.Character};
+	const FVector Location{Character.GetActorLocation() - Lane.Origin};
+
+	if (Location.X > LaneLength || Location.Z < FallResetDepth)
+	{
+		ResetLane(Lane);
+		return;
+	}
+
+	static constexpr EISAGait Gaits[]{EISAGait::Walking, EISAGait::Running, EISAGait::Sprinting};
+	const EISAGait Gait{Gaits[Lane.Lap % UE_ARRAY_COUNT(Gaits)]};
+
+	Character.SetDesiredGait(Gait);
+	Character.GetISACharacterMovement()->SetWantsToSprint(Gait == EISAGait::Sprinting);
+
+	//Crouching on the slope starts the slide, standing up at the bottom ends it
+	Character.SetDesiredStance(Location.X > SlopeX && Location.X < GetSlopeEndX() ? EISAStance::Crouching : EISAStance::Standing);
+
+	//The jump press in front of the obstacle starts the mantle
+	FISAScriptedInput::Jump(Character, Location.X > LedgeX - JumpDistance && Location.X < LedgeX);
+
+	if (FISAScriptedInput::IsPushing(Character))
+	{
+		Lane.PushTime += DeltaTime;
+
+		if (Lane.PushTime > PushDuration)
+		{
+			FISAScriptedInput::Interact(Character);
+		}
+	}
+	else if (!Lane.bPushedThisLap && FMath::Abs(Location.X - CrateX) < InteractDistance)
+	{
+		Lane.bPushedThisLap = true;
+		Lane.PushTime = 0.f;
+
+		FISAScriptedInput::Interact(Character);
+	}
+
+	//Moves the crate instead while pushing
+	FISAScriptedInput::Move(Character, FVector2D{1.f, 0.f});
+}
+
+void UISABenchmarkCommandlet::ResetLane(FLane& Lane)
+{
+	AISAPlayerCharacter& Character{*Lane.Character};
+
+	FISAScriptedInput::EndPush(Character);
+
+	Character.StopAnimMontage();
+
+	const float HalfHeight{Character.GetCapsuleComponent()->GetScaledCapsuleHalfHeight()};
+
+	Character.SetActorLocationAndRotation(Lane.Origin + FVector{100.f, 0.f, HalfHeight + 10.f}, FRotator::ZeroRotator, false, nullptr, ETeleportType::TeleportPhysics);
+	Lane.Crate->SetActorLocation(Lane.Origin + FVector{CrateX, CrateOffset, GetSlopeEndZ() + CrateSize / 2}, false, nullptr, ETeleportType::TeleportPhysics);
+
+	Lane.Lap++;
+	Lane.PushTime = 0.f;
+	Lane.bPushedThisLap = false;
+}
@@ -0,0 +1,185 @@
+#include "Commandlets/ISABenchmarkWorld.h"
+
+#include "ISAPlayerCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Interactibles/ISADoorBase.h"
+#include "Interactibles/ISAPushableBase.h"
+#include "Containers/Ticker.h"
+
+UWorld* FISABenchmarkWorld::Create(FName Name)
+{
+	UWorld* World{UWorld::CreateWorld(EWorldType::Game, false, Name)};
+
+	FWorldContext& WorldContext{GEngine->CreateNewWorldContext(EWorldType::Game)};
+	WorldContext.SetCurrentWorld(World);
+
+	World->AddToRoot();
+
+	return World;
+}
+
+UWorld* FISABenchmarkWorld::CreateForPackage(UPackage& Package, FName Name)
+{
+	UWorld* World{UWorld::CreateWorld(EWorldType::Editor, false, Name, &Package)};
+
+	//Saved as the asset of the package
+	World->SetFlags(RF_Public | RF_Standalone);
+
+	return World;
+}
+
+void FISABenchmarkWorld::BeginPlay(UWorld& World)
+{
+	World.InitializeActorsForPlay(FURL{});
+	World.BeginPlay();
+
+	//Without a game mode nothing tells the actors to begin play
+	if (!World.HasBegunPlay())
+	{
+		World.GetWorldSettings()->NotifyBeginPlay();
+	}
+}
+
+void FISABenchmarkWorld::Destroy(UWorld* World)
+{
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	World->RemoveFromRoot();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+void FISABenchmarkWorld::Tick(UWorld& World, float DeltaTime)
+{
+	GFrameCounter++;
+
+	World.Tick(LEVELTICK_All, DeltaTime);
+
+	FTSTicker::GetCoreTicker().Tick(DeltaTime);
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+}
+
+FISABenchmarkWorld::FISABenchmarkWorld(UWorld& InWorld)
+	: World{InWorld},
+	  CubeMesh{LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"))}
+{
+	check(IsValid(CubeMesh));
+}
+
+AStaticMeshActor* FISABenchmarkWorld::AddBox(const FVector& Location, const FVector& Size, const FRotator& Rotation) const
+{
+	return AddCube(Location + Rotation.RotateVector({0.f, 0.f, Size.Z / 2}), Size, Rotation);
+}
+
+AStaticMeshActor* FISABenchmarkWorld::AddSlope(const FVector& Location, const FVector& Direction, float Length, float Width, float Angle) const
+{
+	const FRotator Rotation{-Angle, Direction.Rotation().Yaw, 0.f};
+	const FVector Up{FRotationMatrix{Rotation}.GetUnitAxis(EAxis::Z)};
+
+	return AddCube(Location + Rotation.Vector() * Length / 2 - Up * SlopeThickness / 2, {Length, Width, SlopeThickness}, Rotation);
+}
+
+AStaticMeshActor* FISABenchmarkWorld::AddMesh(UStaticMesh& Mesh, const FVector& Location, const FVector& Size, const FRotator& Rotation) const
+{
+	const FBox Bounds{Mesh.GetBoundingBox()};
+	const FVector Scale{Size / Bounds.GetSize().ComponentMax(FVector{UE_KINDA_SMALL_NUMBER})};
+
+	//Moves the bottom center of the bounds onto Location
+	const FVector Pivot{-Bounds.GetCenter() * Scale + FVector{0.f, 0.f, Size.Z / 2}};
+	const FTransform Transform{Rotation, Location + Rotation.RotateVector(Pivot), Scale};
+
+	auto* Actor{World.SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform)};
+
+	Actor->GetStaticMeshComponent()->SetStaticMesh(&Mesh);
+	Actor->FinishSpawning(Transform);
+
+	return Actor;
+}
+
+AISAPushableBase* FISABenchmarkWorld::AddCrate(const FVector& Location, float Size) const
+{
+	const float Scale{Size / CubeSize};
+	const FTransform Transform{FQuat::Identity, Location + FVector{0.f, 0.f, Size / 2}, FVector{Scale}};
+
+	auto* Crate{World.SpawnActorDeferred<AISAPushableBase>(AISAPushableBase::StaticClass(), Transform)};
+
+	Crate->Box->SetStaticMesh(CubeMesh);
+
+	//Push transforms are scaled with the crate, so the distance to the side is given in unscaled units
+	const float SideDistance{CubeSize / 2 + PushDistance / Scale};
+
+	TArray<FTransform> PushTransforms;
+
+	for (const FVector& Side : {FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector, FVector::LeftVector})
+	{
+		//On the floor next to the side, facing the crate
+		PushTransforms.Emplace((-Side).Rotation(), Side * SideDistance - FVector{0.f, 0.f, CubeSize / 2});
+	}
+
+	Crate->SetPushTransforms(PushTransforms);
+	Crate->FinishSpawning(Transform);
+
+	return Crate;
+}
+
+AISADoorBase* FISABenchmarkWorld::AddDoor(const FVector& Location, float Yaw, const FVector& WarpOffset) const
+{
+	const FTransform Transform{FRotator{0.f, Yaw, 0.f}, Location};
+
+	auto* Door{World.SpawnActorDeferred<AISADoorBase>(AISADoorBase::StaticClass(), Transform)};
+
+	//The door adds its warp transform to its own, so the rotation and scale are left out
+	Door->SetWarpTransform({FQuat{0.f, 0.f, 0.f, 0.f}, WarpOffset, FVector::ZeroVector});
+	Door->FinishSpawning(Transform);
+
+	//The box is centered on the door
+	Door->AddActorWorldOffset({0.f, 0.f, Door->GetComponentsBoundingBox().GetExtent().Z});
+
+	return Door;
+}
+
+AISAPlayerCharacter* FISABenchmarkWorld::AddCharacter(UClass& CharacterClass, const FVector& Location, const FRotator& Rotation) const
+{
+	const auto* DefaultCharacter{CastChecked<AISAPlayerCharacter>(CharacterClass.GetDefaultObject())};
+	const float HalfHeight{DefaultCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()};
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	auto* Character{World.SpawnActor<AISAPlayerCharacter>(&CharacterClass, Location + FVector{0.f, 0.f, HalfHeight + 10.f}, Rotation, SpawnParameters)};
+
+	if (Character == nullptr)
+	{
+		return nullptr;
+	}
+
+	Character->SpawnDefaultController();
+
+	//Nothing is rendered, the animation still has to run
+	Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	return Character;
+}
+
+AStaticMeshActor* FISABenchmarkWorld::AddCube(const FVector& Center, const FVector& Size, const FRotator& Rotation) const
+{
+	const FTransform Transform{Rotation, Center, Size / CubeSize};
+
+	//Static meshes only take a new mesh before they are registered
+	auto* Actor{World.SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform)};
+
+	Actor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+	Actor->FinishSpawning(Transform);
+
+	return Actor;
+}
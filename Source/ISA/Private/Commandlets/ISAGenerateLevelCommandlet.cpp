@@ -0,0 +1,189 @@
+#include "Commandlets/ISAGenerateLevelCommandlet.h"
+
+#include "Commandlets/ISABenchmarkWorld.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+#include "Math/RandomStream.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogISAGenerateLevel, Log, All);
+
+namespace
+{
+	constexpr float FloorThickness{20.f};
+
+	//Ledges are thin enough to vault and wide enough to hit straight on
+	constexpr float MinLedgeDepth{40.f};
+	constexpr float MaxLedgeDepth{200.f};
+	constexpr float MinLedgeWidth{200.f};
+	constexpr float MaxLedgeWidth{800.f};
+
+	constexpr float MinSlopeLength{400.f};
+	constexpr float MaxSlopeLength{800.f};
+	constexpr float SlopeWidth{400.f};
+
+	constexpr float MinCrateSize{60.f};
+	constexpr float MaxCrateSize{150.f};
+
+	constexpr float DoorWarpDistance{150.f};
+}
+
+UISAGenerateLevelCommandlet::UISAGenerateLevelCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UISAGenerateLevelCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+
+	if (!FParse::Value(*Params, TEXT("Map="), MapName) || !FPackageName::IsValidLongPackageName(MapName))
+	{
+		UE_LOG(LogISAGenerateLevel, Error, TEXT("Missing or invalid -Map=<long package name>"));
+		return 1;
+	}
+
+	int32 Seed{0};
+	int32 FeatureCounts[]{1000, 200, 200, 100};
+	FFeatureRanges Ranges;
+
+	float MinLedgeHeight{Ranges.LedgeHeight.GetLowerBoundValue()};
+	float MaxLedgeHeight{Ranges.LedgeHeight.GetUpperBoundValue()};
+	float MinSlopeAngle{Ranges.SlopeAngle.GetLowerBoundValue()};
+	float MaxSlopeAngle{Ranges.SlopeAngle.GetUpperBoundValue()};
+
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Ledges="), FeatureCounts[static_cast<int32>(EFeature::Ledge)]);
+	FParse::Value(*Params, TEXT("Slopes="), FeatureCounts[static_cast<int32>(EFeature::Slope)]);
+	FParse::Value(*Params, TEXT("Crates="), FeatureCounts[static_cast<int32>(EFeature::Crate)]);
+	FParse::Value(*Params, TEXT("Doors="), FeatureCounts[static_cast<int32>(EFeature::Door)]);
+	FParse::Value(*Params, TEXT("MinLedgeHeight="), MinLedgeHeight);
+	FParse::Value(*Params, TEXT("MaxLedgeHeight="), MaxLedgeHeight);
+	FParse::Value(*Params, TEXT("MinSlopeAngle="), MinSlopeAngle);
+	FParse::Value(*Params, TEXT("MaxSlopeAngle="), MaxSlopeAngle);
+
+	Ranges.LedgeHeight = {MinLedgeHeight, FMath::Max(MinLedgeHeight, MaxLedgeHeight)};
+	Ranges.SlopeAngle = {MinSlopeAngle, FMath::Max(MinSlopeAngle, MaxSlopeAngle)};
+
+	TArray<EFeature> Features;
+
+	for (int32 FeatureIndex = 0; FeatureIndex < UE_ARRAY_COUNT(FeatureCounts); FeatureIndex++)
+	{
+		for (int32 Count = 0; Count < FeatureCounts[FeatureIndex]; Count++)
+		{
+			Features.Add(static_cast<EFeature>(FeatureIndex));
+		}
+	}
+
+	if (Features.IsEmpty())
+	{
+		UE_LOG(LogISAGenerateLevel, Error, TEXT("Nothing to generate, check -Ledges, -Slopes, -Crates and -Doors"));
+		return 1;
+	}
+
+	FRandomStream Stream{Seed};
+
+	//Mixed so every part of the level stresses every code path
+	for (int32 Index = Features.Num() - 1; Index > 0; Index--)
+	{
+		Features.Swap(Index, Stream.RandRange(0, Index));
+	}
+
+	UPackage* MapPackage{CreatePackage(*MapName)};
+	UWorld* World{FISABenchmarkWorld::CreateForPackage(*MapPackage, *FPackageName::GetShortName(MapName))};
+	const FISABenchmarkWorld Builder{*World};
+
+	//Square grid, one floor per row, the first cell stays empty for the player start
+	const int32 ColumnCount{FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Features.Num() + 1)))};
+	const int32 RowCount{FMath::DivideAndRoundUp(Features.Num() + 1, ColumnCount)};
+
+	for (int32 Row = 0; Row < RowCount; Row++)
+	{
+		const float RowLength{ColumnCount * CellSize};
+
+		Builder.AddBox({RowLength / 2 - CellSize / 2, Row * CellSize, -FloorThickness}, {RowLength, CellSize, FloorThickness});
+	}
+
+	World->SpawnActor<APlayerStart>(FVector{0.f, 0.f, 100.f}, FRotator::ZeroRotator);
+
+	for (int32 FeatureIndex = 0; FeatureIndex < Features.Num(); FeatureIndex++)
+	{
+		const int32 Cell{FeatureIndex + 1};
+
+		AddFeature(Builder, Stream, Ranges, Features[FeatureIndex], {Cell % ColumnCount * CellSize, Cell / ColumnCount * CellSize, 0.f});
+	}
+
+	UE_LOG(LogISAGenerateLevel, Display, TEXT("Generated %d ledges, %d slopes, %d crates and %d doors on a %dx%d grid with seed %d"), FeatureCounts[0], FeatureCounts[1],
+	       FeatureCounts[2], FeatureCounts[3], ColumnCount, RowCount, Seed);
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+
+	const FString Filename{FPackageName::LongPackageNameToFilename(MapName, FPackageName::GetMapPackageExtension())};
+	const bool bSaved{UPackage::SavePackage(MapPackage, World, *Filename, SaveArgs)};
+
+	FISABenchmarkWorld::Destroy(World);
+
+	if (!bSaved)
+	{
+		UE_LOG(LogISAGenerateLevel, Error, TEXT("Could not save %s"), *Filename);
+		return 1;
+	}
+
+	return 0;
+#else
+	UE_LOG(LogISAGenerateLevel, Error, TEXT("Levels can only be generated in editor builds"));
+	return 1;
+#endif
+}
+
+void UISAGenerateLevelCommandlet::AddFeature(const FISABenchmarkWorld& Builder, FRandomStream& Stream, const FFeatureRanges& Ranges, EFeature Feature, const FVector& Center)
+{
+	//Quarter turns keep the features inside their cell
+	const FRotator Rotation{0.f, Stream.RandRange(0, 3) * 90.f, 0.f};
+	const FVector Forward{Rotation.Vector()};
+
+	switch (Feature)
+	{
+	case EFeature::Ledge:
+		{
+			const FVector Size{Stream.FRandRange(MinLedgeDepth, MaxLedgeDepth), Stream.FRandRange(MinLedgeWidth, MaxLedgeWidth),
+			                   Stream.FRandRange(Ranges.LedgeHeight.GetLowerBoundValue(), Ranges.LedgeHeight.GetUpperBoundValue())};
+
+			Builder.AddBox(Center, Size, Rotation);
+			break;
+		}
+	case EFeature::Slope:
+		{
+			const float Length{Stream.FRandRange(MinSlopeLength, MaxSlopeLength)};
+			const float Angle{Stream.FRandRange(Ranges.SlopeAngle.GetLowerBoundValue(), Ranges.SlopeAngle.GetUpperBoundValue())};
+			const float Run{Length * FMath::Cos(FMath::DegreesToRadians(Angle))};
+			const float Rise{Length * FMath::Sin(FMath::DegreesToRadians(Angle))};
+
+			//Goes up along Forward onto a platform to slide back down from, both centered in the cell
+			const FVector Bottom{Center - Forward * (Run + SlopeWidth) / 2};
+			const FVector Top{Bottom + Forward * Run + FVector{0.f, 0.f, Rise}};
+
+			Builder.AddSlope(Top, -Forward, Length, SlopeWidth, Angle);
+			Builder.AddBox(Top + Forward * SlopeWidth / 2 - FVector{0.f, 0.f, Rise}, {SlopeWidth, SlopeWidth, Rise}, Rotation);
+			break;
+		}
+	case EFeature::Crate:
+		{
+			Builder.AddCrate(Center, Stream.FRandRange(MinCrateSize, MaxCrateSize));
+			break;
+		}
+	case EFeature::Door:
+		{
+			//The door spans its local X, the warp goes through it
+			Builder.AddDoor(Center, Rotation.Yaw, Rotation.RotateVector(FVector::RightVector) * DoorWarpDistance);
+			break;
+		}
+	}
+}
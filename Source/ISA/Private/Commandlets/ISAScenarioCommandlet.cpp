@@ -0,0 +1,634 @@
+#include "Commandlets/ISAScenarioCommandlet.h"
+
+#include "ISACharacterMovementComponent.h"
+#include "ISAPlayerCharacter.h"
+#include "Commandlets/ISABenchmarkWorld.h"
+#include "Commandlets/ISAScriptedInput.h"
+#include "Dom/JsonObject.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Interactibles/ISADoorBase.h"
+#include "Interactibles/ISAPushableBase.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogISAScenario, Log, All);
+
+namespace
+{
+	constexpr float DeltaTime{1.f / 60.f};
+
+	//Frames the character gets to land before anything is driven or measured
+	constexpr int32 SettleFrameCount{30};
+
+	constexpr float FloorThickness{20.f};
+	constexpr float FloorWidth{600.f};
+	constexpr float JumpDistance{150.f};
+	constexpr float InteractDistance{120.f};
+
+	//Relative tolerances written with a new baseline. The frame time depends on the machine the baseline was recorded on,
+	//so it gets a lot of room. The times of the single code paths are only reported, never written
+	constexpr double CountTolerance{0.05};
+	constexpr double FrameTimeTolerance{0.5};
+	constexpr double RetainedBytesTolerance{0.25};
+
+	//Room on top of the retained bytes tolerance, so a scenario that retained nothing still allows allocator noise
+	constexpr double RetainedBytesSlack{64.0 * 1024.0};
+
+	constexpr const TCHAR* FrameTimeMetric{TEXT("FrameMs")};
+	constexpr const TCHAR* RetainedBytesMetric{TEXT("RetainedBytes")};
+
+#if ISA_WITH_PROFILING
+	//What a scenario drives and checks, filled in by its build function
+	struct FScenarioState
+	{
+		AISAPlayerCharacter* Character{nullptr};
+
+		//Obstacle, crate or door the scenario is about
+		AActor* Target{nullptr};
+
+		FVector TargetStart{ForceInit};
+
+		//Along X, the obstacle to jump over or the point to interact at
+		float ActionX{0.f};
+
+		//Along X, where the character has to end up
+		float GoalX{0.f};
+
+		float Time{0.f};
+
+		bool bInteracted{false};
+
+		bool bSlid{false};
+
+		bool bMantled{false};
+	};
+
+	struct FScenario
+	{
+		FString Name;
+
+		int32 FrameCount{0};
+
+		TFunction<void(const FISABenchmarkWorld&, FScenarioState&)> Build;
+
+		TFunction<void(FScenarioState&)> Drive;
+
+		TFunction<bool(const FScenarioState&)> Check;
+	};
+
+	void DriveForward(AISAPlayerCharacter& Character, EISAGait Gait)
+	{
+		Character.SetDesiredGait(Gait);
+		Character.GetISACharacterMovement()->SetWantsToSprint(Gait == EISAGait::Sprinting);
+
+		FISAScriptedInput::Move(Character, FVector2D{1.f, 0.f});
+	}
+
+	//Floor along X from Start to End, centered on Y
+	void AddFloor(const FISABenchmarkWorld& Builder, float Start, float End, float Z = 0.f)
+	{
+		Builder.AddBox({(Start + End) / 2, 0.f, Z - FloorThickness}, {End - Start, FloorWidth, FloorThickness});
+	}
+
+	FScenario MakeSlideScenario()
+	{
+		static constexpr float SlopeX{500.f};
+		static constexpr float SlopeLength{3000.f};
+		static constexpr float SlopeAngle{20.f};
+
+		FScenario Scenario;
+		Scenario.Name = TEXT("SlideLongSlope");
+		Scenario.FrameCount = 600;
+
+		Scenario.Build = [](const FISABenchmarkWorld& Builder, FScenarioState& State)
+		{
+			const float SlopeEndX{SlopeX + SlopeLength * FMath::Cos(FMath::DegreesToRadians(SlopeAngle))};
+			const float SlopeEndZ{-SlopeLength * FMath::Sin(FMath::DegreesToRadians(SlopeAngle))};
+
+			AddFloor(Builder, -500.f, SlopeX);
+			Builder.AddSlope({SlopeX, 0.f, 0.f}, FVector::ForwardVector, SlopeLength, FloorWidth, SlopeAngle);
+			AddFloor(Builder, SlopeEndX, SlopeEndX + 3000.f, SlopeEndZ);
+
+			State.ActionX = SlopeX;
+			State.GoalX = SlopeEndX;
+		};
+
+		Scenario.Drive = [](FScenarioState& State)
+		{
+			AISAPlayerCharacter& Character{*State.Character};
+
+			//Crouching on the slope starts the slide
+			Character.SetDesiredStance(Character.GetActorLocation().X > State.ActionX ? EISAStance::Crouching : EISAStance::Standing);
+
+			DriveForward(Character, EISAGait::Sprinting);
+		};
+
+		Scenario.Check = [](const FScenarioState& State)
+		{
+			return State.bSlid && State.Character->GetActorLocation().X > State.GoalX;
+		};
+
+		return Scenario;
+	}
+
+	FScenario MakeVaultScenario(const TCHAR* MeshName)
+	{
+		static constexpr float ObstacleX{600.f};
+		static const FVector ObstacleSize{60.f, 300.f, 100.f};
+
+		FScenario Scenario;
+		Scenario.Name = FString::Printf(TEXT("Vault_%s"), MeshName);
+		Scenario.FrameCount = 300;
+
+		const FString MeshPath{FString::Printf(TEXT("/Game/LevelPrototyping/Meshes/%s.%s"), MeshName, MeshName)};
+
+		Scenario.Build = [MeshPath](const FISABenchmarkWorld& Builder, FScenarioState& State)
+		{
+			AddFloor(Builder, -500.f, 2000.f);
+
+			if (UStaticMesh* Mesh{LoadObject<UStaticMesh>(nullptr, *MeshPath)})
+			{
+				State.Target = Builder.AddMesh(*Mesh, {ObstacleX + ObstacleSize.X / 2, 0.f, 0.f}, ObstacleSize);
+			}
+			else
+			{
+				UE_LOG(LogISAScenario, Error, TEXT("Could not load %s"), *MeshPath);
+			}
+
+			State.ActionX = ObstacleX;
+			State.GoalX = ObstacleX + ObstacleSize.X;
+		};
+
+		Scenario.Drive = [](FScenarioState& State)
+		{
+			AISAPlayerCharacter& Character{*State.Character};
+			const float X{Character.GetActorLocation().X};
+
+			//The jump press in front of the obstacle starts the mantle
+			FISAScriptedInput::Jump(Character, X > State.ActionX - JumpDistance && X < State.ActionX);
+
+			DriveForward(Character, EISAGait::Running);
+		};
+
+		Scenario.Check = [](const FScenarioState& State)
+		{
+			return State.Target != nullptr && State.bMantled && State.Character->GetActorLocation().X > State.GoalX;
+		};
+
+		return Scenario;
+	}
+
+	FScenario MakePushScenario()
+	{
+		static constexpr float RoomSize{2000.f};
+		static constexpr float WallHeight{200.f};
+		static constexpr float WallThickness{20.f};
+		static constexpr float CrateX{300.f};
+		static constexpr float CrateSize{100.f};
+		static constexpr float PushDuration{4.f};
+		static constexpr float MinPushDistance{150.f};
+
+		FScenario Scenario;
+		Scenario.Name = TEXT("PushAcrossRoom");
+		Scenario.FrameCount = 420;
+
+		Scenario.Build = [](const FISABenchmarkWorld& Builder, FScenarioState& State)
+		{
+			Builder.AddBox({0.f, 0.f, -FloorThickness}, {RoomSize, RoomSize, FloorThickness});
+
+			for (const FVector& Side : {FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector, FVector::LeftVector})
+			{
+				const FVector Size{Side.X != 0.f ? FVector{WallThickness, RoomSize, WallHeight} : FVector{RoomSize, WallThickness, WallHeight}};
+
+				Builder.AddBox(Side * (RoomSize + WallThickness) / 2, Size);
+			}
+
+			State.Target = Builder.AddCrate({CrateX, 0.f, 0.f}, CrateSize);
+			State.TargetStart = State.Target->GetActorLocation();
+			State.ActionX = CrateX - CrateSize / 2;
+		};
+
+		Scenario.Drive = [](FScenarioState& State)
+		{
+			AISAPlayerCharacter& Character{*State.Character};
+
+			if (FISAScriptedInput::IsPushing(Character))
+			{
+				if (State.Time > PushDuration)
+				{
+					FISAScriptedInput::EndPush(Character);
+				}
+			}
+			else if (!State.bInteracted && State.ActionX - Character.GetActorLocation().X < InteractDistance)
+			{
+				State.bInteracted = true;
+				State.Time = 0.f;
+
+				FISAScriptedInput::Interact(Character);
+			}
+
+			//Moves the crate instead while pushing
+			DriveForward(Character, EISAGait::Walking);
+		};
+
+		Scenario.Check = [](const FScenarioState& State)
+		{
+			return FVector::Dist2D(State.Target->GetActorLocation(), State.TargetStart) > MinPushDistance;
+		};
+
+		return Scenario;
+	}
+
+	FScenario MakeDoorScenario()
+	{
+		static constexpr float DoorX{400.f};
+		static constexpr float WarpDistance{150.f};
+
+		FScenario Scenario;
+		Scenario.Name = TEXT("DoorWarp");
+		Scenario.FrameCount = 240;
+
+		Scenario.Build = [](const FISABenchmarkWorld& Builder, FScenarioState& State)
+		{
+			AddFloor(Builder, -500.f, 1500.f);
+
+			//Turned so the door spans the floor
+			State.Target = Builder.AddDoor({DoorX, 0.f, 0.f}, 90.f, {WarpDistance, 0.f, 0.f});
+			State.ActionX = DoorX;
+			State.GoalX = DoorX + WarpDistance / 2;
+		};
+
+		Scenario.Drive = [](FScenarioState& State)
+		{
+			AISAPlayerCharacter& Character{*State.Character};
+
+			if (!State.bInteracted && State.ActionX - Character.GetActorLocation().X < InteractDistance)
+			{
+				State.bInteracted = true;
+
+				FISAScriptedInput::Interact(Character);
+			}
+
+			DriveForward(Character, EISAGait::Walking);
+		};
+
+		Scenario.Check = [](const FScenarioState& State)
+		{
+			return State.Character->GetActorLocation().X > State.GoalX;
+		};
+
+		return Scenario;
+	}
+
+	TArray<FScenario> MakeScenarios()
+	{
+		TArray<FScenario> Scenarios;
+		Scenarios.Add(MakeSlideScenario());
+
+		for (const TCHAR* MeshName : {TEXT("SM_ChamferCube"), TEXT("SM_Cube"), TEXT("SM_Cylinder"), TEXT("SM_QuarterCylinder"), TEXT("SM_Ramp")})
+		{
+			Scenarios.Add(MakeVaultScenario(MeshName));
+		}
+
+		Scenarios.Add(MakePushScenario());
+		Scenarios.Add(MakeDoorScenario());
+
+		return Scenarios;
+	}
+
+	//Metric name to value, per frame for times and per scenario for counts. False when the scenario did not reach its goal
+	bool RunScenario(const FScenario& Scenario, UClass& CharacterClass, TMap<FString, double>& OutMetrics)
+	{
+		UWorld* World{FISABenchmarkWorld::Create(*FString::Printf(TEXT("ISAScenario_%s"), *Scenario.Name))};
+		const FISABenchmarkWorld Builder{*World};
+
+		FScenarioState State;
+		Scenario.Build(Builder, State);
+
+		FISABenchmarkWorld::BeginPlay(*World);
+
+		State.Character = Builder.AddCharacter(CharacterClass, FVector::ZeroVector);
+
+		if (State.Character == nullptr)
+		{
+			FISABenchmarkWorld::Destroy(World);
+			return false;
+		}
+
+		//Montage bundles and anim layers requested on BeginPlay, a scenario must not depend on how fast they stream in
+		FlushAsyncLoading();
+
+		for (int32 Frame = 0; Frame < SettleFrameCount; Frame++)
+		{
+			FISABenchmarkWorld::Tick(*World, DeltaTime);
+		}
+
+		ISAProfiling::Reset();
+		ISAProfiling::bEnabled = true;
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		//Memory the ISA code paths hold on to while the scenario runs, only tracked with -llm
+		const bool bTrackMemory{FLowLevelMemTracker::IsEnabled()};
+		int64 StartBytes{0};
+
+		if (bTrackMemory)
+		{
+			FLowLevelMemTracker::Get().UpdateStatsPerFrame();
+			StartBytes = ISAMemory::GetTrackedBytes();
+		}
+#endif
+
+		double FrameSeconds{0.0};
+
+		for (int32 Frame = 0; Frame < Scenario.FrameCount; Frame++)
+		{
+			Scenario.Drive(State);
+
+			const double StartSeconds{FPlatformTime::Seconds()};
+
+			FISABenchmarkWorld::Tick(*World, DeltaTime);
+
+			FrameSeconds += FPlatformTime::Seconds() - StartSeconds;
+
+			State.Time += DeltaTime;
+			State.bSlid |= State.Character->GetISACharacterMovement()->IsCustomMovementMode(CMOVE_Slide);
+			State.bMantled |= State.Character->GetLocomotionState().LocomotionAction == EISALocomotionAction::Mantling;
+		}
+
+		ISAProfiling::bEnabled = false;
+
+		OutMetrics.Add(FrameTimeMetric, FrameSeconds * 1000.0 / Scenario.FrameCount);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (bTrackMemory)
+		{
+			FLowLevelMemTracker::Get().UpdateStatsPerFrame();
+			OutMetrics.Add(RetainedBytesMetric, ISAMemory::GetTrackedBytes() - StartBytes);
+		}
+#endif
+
+		for (int32 TimerIndex = 0; TimerIndex < ISAProfiling::TimerCount; TimerIndex++)
+		{
+			const auto Timer{static_cast<ISAProfiling::ETimer>(TimerIndex)};
+
+			OutMetrics.Add(FString::Printf(TEXT("%sMs"), ISAProfiling::ToString(Timer)), ISAProfiling::GetTimerSeconds(Timer) * 1000.0 / Scenario.FrameCount);
+		}
+
+		for (int32 CounterIndex = 0; CounterIndex < ISAProfiling::CounterCount; CounterIndex++)
+		{
+			const auto Counter{static_cast<ISAProfiling::ECounter>(CounterIndex)};
+
+			OutMetrics.Add(ISAProfiling::ToString(Counter), ISAProfiling::GetCounter(Counter));
+		}
+
+		const bool bPassed{Scenario.Check(State)};
+
+		FISABenchmarkWorld::Destroy(World);
+
+		return bPassed;
+	}
+
+	//Times are per frame and compared in ms, counts are whole numbers per scenario
+	bool IsTimeMetric(const FString& MetricName)
+	{
+		return MetricName.EndsWith(TEXT("Ms"));
+	}
+
+	//Counts, the frame time and the retained bytes are part of the baseline, the times of the single code paths are not
+	bool IsBaselineMetric(const FString& MetricName)
+	{
+		return !IsTimeMetric(MetricName) || MetricName == FrameTimeMetric;
+	}
+
+	double GetBaselineTolerance(const FString& MetricName)
+	{
+		if (MetricName == FrameTimeMetric)
+		{
+			return FrameTimeTolerance;
+		}
+
+		return MetricName == RetainedBytesMetric ? RetainedBytesTolerance : CountTolerance;
+	}
+
+	double GetBaselineLimit(const FString& MetricName, double Value, double Tolerance)
+	{
+		if (IsTimeMetric(MetricName))
+		{
+			return Value * (1.0 + Tolerance);
+		}
+
+		if (MetricName == RetainedBytesMetric)
+		{
+			return FMath::Max(Value, 0.0) * (1.0 + Tolerance) + RetainedBytesSlack;
+		}
+
+		//A count that was zero has no room, that is what catches a new trace in a path that had none
+		return FMath::FloorToDouble(Value * (1.0 + Tolerance));
+	}
+
+	//False when a metric is over its baseline value by more than its tolerance, or when the frame time or the retained bytes
+	//of the baseline were not measured. Counts without a baseline only warn
+	bool CompareToBaseline(const FString& ScenarioName, const TMap<FString, double>& Metrics, const FJsonObject& Baseline)
+	{
+		const TSharedPtr<FJsonObject>* ScenarioBaseline;
+
+		if (!Baseline.TryGetObjectField(ScenarioName, ScenarioBaseline))
+		{
+			UE_LOG(LogISAScenario, Warning, TEXT("%s has no baseline"), *ScenarioName);
+			return true;
+		}
+
+		bool bWithinTolerance{true};
+
+		for (const TCHAR* RequiredMetric : {FrameTimeMetric, RetainedBytesMetric})
+		{
+			if ((*ScenarioBaseline)->HasField(RequiredMetric) && !Metrics.Contains(RequiredMetric))
+			{
+				UE_LOG(LogISAScenario, Error, TEXT("%s %s is in the baseline but was not measured, run with -llm"), *ScenarioName, RequiredMetric);
+				bWithinTolerance = false;
+			}
+		}
+
+		for (const TPair<FString, double>& Metric : Metrics)
+		{
+			const TSharedPtr<FJsonObject>* MetricBaseline;
+
+			if (!(*ScenarioBaseline)->TryGetObjectField(Metric.Key, MetricBaseline))
+			{
+				if (IsBaselineMetric(Metric.Key))
+				{
+					UE_LOG(LogISAScenario, Warning, TEXT("%s %s has no baseline"), *ScenarioName, *Metric.Key);
+				}
+
+				continue;
+			}
+
+			const double Value{(*MetricBaseline)->GetNumberField(TEXT("Value"))};
+			const double Tolerance{(*MetricBaseline)->GetNumberField(TEXT("Tolerance"))};
+
+			const double Limit{GetBaselineLimit(Metric.Key, Value, Tolerance)};
+
+			if (Metric.Value > Limit)
+			{
+				UE_LOG(LogISAScenario, Error, TEXT("%s %s regressed: %.4f, baseline %.4f, limit %.4f"), *ScenarioName, *Metric.Key, Metric.Value, Value, Limit);
+				bWithinTolerance = false;
+			}
+		}
+
+		return bWithinTolerance;
+	}
+
+	TSharedRef<FJsonObject> MakeBaseline(const TMap<FString, double>& Metrics)
+	{
+		const auto ScenarioBaseline{MakeShared<FJsonObject>()};
+
+		for (const TPair<FString, double>& Metric : Metrics)
+		{
+			if (!IsBaselineMetric(Metric.Key))
+			{
+				continue;
+			}
+
+			const auto MetricBaseline{MakeShared<FJsonObject>()};
+			MetricBaseline->SetNumberField(TEXT("Value"), Metric.Value);
+			MetricBaseline->SetNumberField(TEXT("Tolerance"), GetBaselineTolerance(Metric.Key));
+
+			ScenarioBaseline->SetObjectField(Metric.Key, MetricBaseline);
+		}
+
+		return ScenarioBaseline;
+	}
+#endif
+}
+
+UISAScenarioCommandlet::UISAScenarioCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UISAScenarioCommandlet::Main(const FString& Params)
+{
+#if ISA_WITH_PROFILING
+	FString ScenarioFilter;
+	FString CharacterClassName{FISABenchmarkWorld::DefaultCharacterClass};
+	FString BaselineFile{FPaths::ProjectDir() / TEXT("Benchmarks/ISAScenarioBaseline.json")};
+
+	FParse::Value(*Params, TEXT("Scenario="), ScenarioFilter);
+	FParse::Value(*Params, TEXT("CharacterClass="), CharacterClassName);
+	FParse::Value(*Params, TEXT("Baseline="), BaselineFile);
+
+	const bool bWriteBaseline{FParse::Param(*Params, TEXT("WriteBaseline"))};
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	const bool bTrackMemory{FLowLevelMemTracker::IsEnabled()};
+#else
+	const bool bTrackMemory{false};
+#endif
+
+	//A baseline without the retained bytes could never catch a leak
+	if (bWriteBaseline && !bTrackMemory)
+	{
+		UE_LOG(LogISAScenario, Error, TEXT("Record the baseline with -llm, the retained bytes are part of it"));
+		return 1;
+	}
+
+	UClass* CharacterClass{LoadClass<AISAPlayerCharacter>(nullptr, *CharacterClassName)};
+
+	if (CharacterClass == nullptr)
+	{
+		UE_LOG(LogISAScenario, Error, TEXT("Could not load -CharacterClass=%s"), *CharacterClassName);
+		return 1;
+	}
+
+	//Existing entries are kept when a baseline is written for some of the scenarios
+	TSharedPtr<FJsonObject> Baseline;
+	FString BaselineJson;
+
+	if (FFileHelper::LoadFileToString(BaselineJson, *BaselineFile))
+	{
+		FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline);
+	}
+
+	if (!Baseline.IsValid())
+	{
+		if (!bWriteBaseline)
+		{
+			UE_LOG(LogISAScenario, Error, TEXT("No baseline at %s, record one on the reference machine with -llm -WriteBaseline"), *BaselineFile);
+			return 1;
+		}
+
+		Baseline = MakeShared<FJsonObject>();
+	}
+
+	int32 ScenarioCount{0};
+	int32 FailureCount{0};
+
+	for (const FScenario& Scenario : MakeScenarios())
+	{
+		if (!ScenarioFilter.IsEmpty() && Scenario.Name != ScenarioFilter)
+		{
+			continue;
+		}
+
+		ScenarioCount++;
+
+		TMap<FString, double> Metrics;
+		bool bPassed{RunScenario(Scenario, *CharacterClass, Metrics)};
+
+		if (!bPassed)
+		{
+			UE_LOG(LogISAScenario, Error, TEXT("%s did not reach its goal"), *Scenario.Name);
+		}
+
+		if (bWriteBaseline)
+		{
+			Baseline->SetObjectField(Scenario.Name, MakeBaseline(Metrics));
+		}
+		else
+		{
+			bPassed &= CompareToBaseline(Scenario.Name, Metrics, *Baseline);
+		}
+
+		UE_LOG(LogISAScenario, Display, TEXT("%-28s %s %8.3f ms/frame %6llu queries"), *Scenario.Name, bPassed ? TEXT("passed") : TEXT("FAILED"),
+		       Metrics.FindRef(FrameTimeMetric), ISAProfiling::GetCounter(ISAProfiling::ECounter::PhysicsQueries));
+
+		FailureCount += bPassed ? 0 : 1;
+	}
+
+	if (ScenarioCount == 0)
+	{
+		UE_LOG(LogISAScenario, Error, TEXT("No scenario named %s"), *ScenarioFilter);
+		return 1;
+	}
+
+	if (bWriteBaseline)
+	{
+		FString Json;
+		FJsonSerializer::Serialize(Baseline.ToSharedRef(), TJsonWriterFactory<>::Create(&Json));
+
+		if (!FFileHelper::SaveStringToFile(Json, *BaselineFile))
+		{
+			UE_LOG(LogISAScenario, Error, TEXT("Could not write %s"), *BaselineFile);
+			return 1;
+		}
+
+		UE_LOG(LogISAScenario, Display, TEXT("Baseline written to %s"), *BaselineFile);
+	}
+
+	UE_LOG(LogISAScenario, Display, TEXT("%d of %d scenarios passed"), ScenarioCount - FailureCount, ScenarioCount);
+
+	return FailureCount > 0 ? 1 : 0;
+#else
+	UE_LOG(LogISAScenario, Error, TEXT("The ISA timers are compiled out of this build"));
+	return 1;
+#endif
+}
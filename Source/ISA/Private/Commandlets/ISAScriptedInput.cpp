@@ -0,0 +1,34 @@
+#include "Commandlets/ISAScriptedInput.h"
+
+#include "ISAPlayerCharacter.h"
+#include "InputActionValue.h"
+#include "Interactibles/ISAPushComponent.h"
+
+void FISAScriptedInput::Move(AISAPlayerCharacter& Character, const FVector2D& Direction)
+{
+	//The move action maps forward to Y
+	Character.Input_OnMove(FInputActionValue{FVector2D{Direction.Y, Direction.X}});
+}
+
+void FISAScriptedInput::Jump(AISAPlayerCharacter& Character, bool bPressed)
+{
+	Character.Input_OnJump(FInputActionValue{bPressed});
+}
+
+void FISAScriptedInput::Interact(AISAPlayerCharacter& Character)
+{
+	Character.Input_OnInteract();
+}
+
+bool FISAScriptedInput::IsPushing(const AISAPlayerCharacter& Character)
+{
+	return Character.PushComponent->IsPushingObject();
+}
+
+void FISAScriptedInput::EndPush(AISAPlayerCharacter& Character)
+{
+	if (IsPushing(Character))
+	{
+		Character.PushComponent->EndPush();
+	}
+}
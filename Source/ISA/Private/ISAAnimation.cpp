@@ -3,9 +3,17 @@
 #include "ISAAnimation.h"
 
 #include "ISACharacterBase.h"
+#include "ISACharacterMovementComponent.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/AssetManager.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAPoseDatabase.h"
+#include "Utility/ISAProfiling.h"
 
 void UISAAnimation::NativeInitializeAnimation()
 {
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
 	Super::NativeInitializeAnimation();
 
 	ISACharacter = Cast<AISACharacterBase>(GetOwningActor());
@@ -22,27 +30,248 @@ void UISAAnimation::NativeInitializeAnimation()
 
 void UISAAnimation::NativeBeginPlay()
 {
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
 	Super::NativeBeginPlay();
 
-	ensure(IsValid(ISACharacter));
+	if (!ensure(IsValid(ISACharacter)))
+	{
+		return;
+	}
+
+	//Only copy the locomotion state when it changes
+	ISACharacter->OnLocomotionModeChangedDelegate.AddWeakLambda(this, [this](AISACharacterBase&, EISALocomotionMode, EISALocomotionMode) { MarkLocomotionStateDirty(); });
+	ISACharacter->OnStanceChangedDelegate.AddUObject(this, &ThisClass::OnStanceChanged);
+	ISACharacter->OnGaitChangedDelegate.AddWeakLambda(this, [this](AISACharacterBase&, EISAGait, EISAGait) { MarkLocomotionStateDirty(); });
+	ISACharacter->OnLocomotionActionChangedDelegate.AddUObject(this, &ThisClass::OnLocomotionActionChanged);
+
+	//Layers for stances and actions the character may never enter are left unloaded
+	for (const auto& [Tag, Layer] : StanceLayers)
+	{
+		if (Layer.bPreload || Tag == ISALocomotionState::ToTag(ISACharacter->GetLocomotionState().Stance))
+		{
+			RequestLinkedLayer(&Layer);
+		}
+	}
+
+	for (const auto& [Tag, Layer] : LocomotionActionLayers)
+	{
+		if (Layer.bPreload)
+		{
+			RequestLinkedLayer(&Layer);
+		}
+	}
+
+	RefreshLinkedLayers();
+}
+
+void UISAAnimation::NativeUninitializeAnimation()
+{
+	if (IsValid(ISACharacter))
+	{
+		ISACharacter->OnLocomotionModeChangedDelegate.RemoveAll(this);
+		ISACharacter->OnStanceChangedDelegate.RemoveAll(this);
+		ISACharacter->OnGaitChangedDelegate.RemoveAll(this);
+		ISACharacter->OnLocomotionActionChangedDelegate.RemoveAll(this);
+	}
+
+	LayerLoadHandles.Reset();
+
+	Super::NativeUninitializeAnimation();
+}
+
+void UISAAnimation::MarkLocomotionStateDirty()
+{
+	bLocomotionStateDirty = true;
+}
+
+void UISAAnimation::OnStanceChanged(AISACharacterBase& Character, EISAStance PreviousStance, EISAStance NewStance)
+{
+	MarkLocomotionStateDirty();
+
+	RequestLinkedLayer(StanceLayers.Find(ISALocomotionState::ToTag(NewStance)));
+	RefreshLinkedLayers();
+}
+
+void UISAAnimation::OnLocomotionActionChanged(AISACharacterBase& Character, EISALocomotionAction PreviousLocomotionAction, EISALocomotionAction NewLocomotionAction)
+{
+	MarkLocomotionStateDirty();
+
+	RequestLinkedLayer(LocomotionActionLayers.Find(ISALocomotionState::ToTag(NewLocomotionAction)));
+	RefreshLinkedLayers();
+}
+
+void UISAAnimation::RequestLinkedLayer(const FISALinkedLayer* Layer)
+{
+	if (Layer == nullptr || Layer->LayerClass.IsNull())
+	{
+		return;
+	}
+
+	const FSoftObjectPath& LayerPath{Layer->LayerClass.ToSoftObjectPath()};
+
+	if (LayerLoadHandles.Contains(LayerPath))
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
+	LayerLoadHandles.Add(LayerPath, UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		                     LayerPath, FStreamableDelegate::CreateWeakLambda(this, [this] { RefreshLinkedLayers(); })));
+}
+
+void UISAAnimation::RefreshLinkedLayers()
+{
+	if (!IsValid(ISACharacter))
+	{
+		return;
+	}
+
+	//Layers that are still loading are linked from the load callback
+	auto FindLoadedLayer{[](const TMap<FGameplayTag, FISALinkedLayer>& Layers, const FGameplayTag& Tag) -> TSubclassOf<UAnimInstance>
+	{
+		const FISALinkedLayer* Layer{Layers.Find(Tag)};
+		return Layer != nullptr ? Layer->LayerClass.Get() : nullptr;
+	}};
+
+	const FISALocomotionState& State{ISACharacter->GetLocomotionState()};
+
+	const TSubclassOf<UAnimInstance> NewStanceLayer{FindLoadedLayer(StanceLayers, ISALocomotionState::ToTag(State.Stance))};
+	const TSubclassOf<UAnimInstance> NewLocomotionActionLayer{FindLoadedLayer(LocomotionActionLayers, ISALocomotionState::ToTag(State.LocomotionAction))};
+
+	const bool bStanceLayerChanged{NewStanceLayer != LinkedStanceLayer};
+	const bool bLocomotionActionLayerChanged{NewLocomotionActionLayer != LinkedLocomotionActionLayer};
+
+	if (bStanceLayerChanged)
+	{
+		if (LinkedStanceLayer != nullptr)
+		{
+			UnlinkAnimClassLayers(LinkedStanceLayer);
+		}
+
+		LinkedStanceLayer = NewStanceLayer;
+
+		if (LinkedStanceLayer != nullptr)
+		{
+			LinkAnimClassLayers(LinkedStanceLayer);
+		}
+	}
+
+	if (bLocomotionActionLayerChanged)
+	{
+		if (LinkedLocomotionActionLayer != nullptr)
+		{
+			UnlinkAnimClassLayers(LinkedLocomotionActionLayer);
+
+			//Unlinking resets the layers the action covered, linking the stance class again only fills those in and keeps its running instance
+			if (!bStanceLayerChanged && LinkedStanceLayer != nullptr)
+			{
+				LinkAnimClassLayers(LinkedStanceLayer);
+			}
+		}
+
+		LinkedLocomotionActionLayer = NewLocomotionActionLayer;
+	}
+
+	//The action layer overrides the stance layer, so it goes on top again when the stance layer below it was swapped
+	if (LinkedLocomotionActionLayer != nullptr && (bLocomotionActionLayerChanged || bStanceLayerChanged))
+	{
+		LinkAnimClassLayers(LinkedLocomotionActionLayer);
+	}
 }
 
 void UISAAnimation::NativeUpdateAnimation(float DeltaTime)
 {
 	Super::NativeUpdateAnimation(DeltaTime);
 
+	ISA_SCOPED_TIMER(AnimUpdate);
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
 	if (!IsValid(ISACharacter))
 	{
 		return;
 	}
 
-	LocomotionMode = ISACharacter->GetLocomotionMode();
-	Stance = ISACharacter->GetStance();
-	Gait = ISACharacter->GetGait();
+	//Only copy here, this runs on the game thread
+	Snapshot.bLocomotionStateChanged = bLocomotionStateDirty;
+
+	if (bLocomotionStateDirty)
+	{
+		Snapshot.LocomotionState = ISACharacter->GetLocomotionState();
+		bLocomotionStateDirty = false;
+	}
+
+	const UISACharacterMovementComponent* CharacterMovement{ISACharacter->GetISACharacterMovement()};
+
+	Snapshot.Speed = CharacterMovement->Speed;
+	Snapshot.bHasInput = CharacterMovement->bHasInput;
+
+	if (IsValid(PoseDatabase))
+	{
+		//The mesh is turned against the capsule, the pose features are in its space
+		const FQuat Rotation{GetSkelMeshComponent()->GetComponentQuat()};
+
+		Snapshot.LocalVelocity = Rotation.UnrotateVector(CharacterMovement->Velocity);
+		Snapshot.LocalAcceleration = Rotation.UnrotateVector(CharacterMovement->GetCurrentAcceleration());
+		Snapshot.MaxSpeed = CharacterMovement->GetMaxSpeed();
+	}
+}
+
+void UISAAnimation::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaTime);
+
+	ISA_SCOPED_TIMER(AnimThreadSafeUpdate);
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
+	if (Snapshot.bLocomotionStateChanged)
+	{
+		LocomotionMode = ISALocomotionState::ToTag(Snapshot.LocomotionState.LocomotionMode);
+		Stance = ISALocomotionState::ToTag(Snapshot.LocomotionState.Stance);
+		Gait = ISALocomotionState::ToTag(Snapshot.LocomotionState.Gait);
+		LocomotionAction = ISALocomotionState::ToTag(Snapshot.LocomotionState.LocomotionAction);
+	}
+
+	Speed = Snapshot.Speed;
+	bHasInput = Snapshot.bHasInput;
+	bIsMoving = Speed > UE_KINDA_SMALL_NUMBER;
+
+	if (IsValid(PoseDatabase))
+	{
+		UpdateMotionMatching(DeltaTime);
+	}
+}
+
+void UISAAnimation::UpdateMotionMatching(float DeltaTime)
+{
+	//Advance the playing pose, the blueprint evaluates it at this time
+	if (IsValid(MotionMatchedSequence))
+	{
+		const float Length{MotionMatchedSequence->GetPlayLength()};
+
+		MotionMatchedTime = MotionMatchedSequence->bLoop && Length > 0.f
+			                    ? FMath::Fmod(MotionMatchedTime + DeltaTime, Length)
+			                    : FMath::Min(MotionMatchedTime + DeltaTime, Length);
+	}
+
+	TimeSinceSearch += DeltaTime;
+
+	if (TimeSinceSearch < SearchInterval && IsValid(MotionMatchedSequence))
+	{
+		return;
+	}
+
+	TimeSinceSearch = 0.f;
+
+	float Query[ISAPoseSearch::FeatureCount];
+	UISAPoseDatabase::MakeQuery(Snapshot.LocalVelocity, Snapshot.LocalAcceleration, Snapshot.MaxSpeed, Query);
+
+	FISAPoseSearchResult Result;
 
-	if (LocomotionAction != ISACharacter->GetLocomotionAction())
+	if (PoseDatabase->Search(Query, MotionMatchedSequence, MotionMatchedTime, ContinuingCostBias, Result))
 	{
-		LocomotionAction = ISACharacter->GetLocomotionAction();
+		MotionMatchedSequence = Result.Sequence;
+		MotionMatchedTime = Result.Time;
 	}
-	
 }
@@ -6,23 +6,39 @@
 #include "ISACharacterMovementComponent.h"
 #include "Utility/ISASettings.h"
 #include "Utility/MantleSettings.h"
+#include "Utility/ISACsvStatsSubsystem.h"
+#include "Utility/ISAMantleSubsystem.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
+#include "Utility/ISATrace.h"
+#include "Utility/ISASignificanceSubsystem.h"
 #include "TimerManager.h"
 #include "Camera/CameraComponent.h"
+#include "Engine/AssetManager.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Engine/Canvas.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "Interactibles/ISAPushComponent.h"
+#include "MotionWarpingComponent.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Net/UnrealNetwork.h"
+#include "Utility/ISALocomotionState.h"
 
 
 // AISACharacter
 
-AISACharacterBase::AISACharacterBase(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer.SetDefaultSubobjectClass<UISACharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
+AISACharacterBase::AISACharacterBase(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer
+	.SetDefaultSubobjectClass<UISACharacterMovementComponent>(ACharacter::CharacterMovementComponentName)
+	.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
-	PrimaryActorTick.bCanEverTick = true;
+	LLM_SCOPE_BYTAG(ISA_Character);
+
+	//Locomotion is refreshed by the movement component, the actor itself never ticks
+	PrimaryActorTick.bCanEverTick = false;
 	// Set default CMC 
 	ISACharacterMovementComponent = Cast<UISACharacterMovementComponent>(GetCharacterMovement());
 	// Set size for collision capsule
@@ -62,11 +78,22 @@ AISACharacterBase::AISACharacterBase(const FObjectInitializer& ObjectInitializer
 
 	// Initialize PushComponent
 	PushComponent = CreateDefaultSubobject<UISAPushComponent>(TEXT("PushComponent"));
+
+	// Initialize MotionWarping, used by the mantle montages
+	MotionWarping = CreateDefaultSubobject<UMotionWarpingComponent>(TEXT("MotionWarping"));
+
+	// The budget is opt-in through the settings, see RegisterAnimationBudget
+	if (auto* BudgetedMesh{Cast<USkeletalMeshComponentBudgeted>(GetMesh())})
+	{
+		BudgetedMesh->SetAutoRegisterWithBudgetAllocator(false);
+	}
 }
 
 
 void AISACharacterBase::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(ISA_Character);
+
 	ensure(IsValid(GeneralSettings));
 	ensure(IsValid(MantleSettings));
 	
@@ -75,23 +102,89 @@ void AISACharacterBase::BeginPlay()
 	
 	ApplyDesiredStance();
 
-	ISACharacterMovementComponent->SetStance(Stance);
+	ISACharacterMovementComponent->SetStance(LocomotionState.Stance);
 
 	RefreshGait();
 
 	SetForceGait(true, false);
+
+	//A slide or a mantle can follow right after spawning and a probe only finds the obstacle a few frames before the jump,
+	//both are loaded right away so the first one never has to wait for its montage
+	PreloadAssetBundle(GeneralSettings, ISAAssetBundles::Slide);
+	PreloadAssetBundle(MantleSettings, ISAAssetBundles::Mantle);
+
+	if (MantleSettings->ProbeMode == EISAMantleProbeMode::Batched)
+	{
+		GetWorld()->GetSubsystem<UISAMantleSubsystem>()->RegisterCharacter(this);
+	}
+
+	DefaultVisibilityBasedAnimTickOption = GetMesh()->VisibilityBasedAnimTickOption;
+	bDefaultEnableUpdateRateOptimizations = GetMesh()->bEnableUpdateRateOptimizations;
+
+	RegisterAnimationBudget();
+
+	if (auto* SignificanceSubsystem{GetWorld()->GetSubsystem<UISASignificanceSubsystem>()})
+	{
+		SignificanceSubsystem->RegisterCharacter(this);
+	}
+
+	if (auto* CsvStatsSubsystem{GetWorld()->GetSubsystem<UISACsvStatsSubsystem>()})
+	{
+		CsvStatsSubsystem->RegisterCharacter(this);
+	}
+}
+
+void AISACharacterBase::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	//Who controls the character decides what its tier may throttle, the next significance update applies it again
+	SignificanceTier = INDEX_NONE;
+
+	//The player usually possesses the character after BeginPlay
+	if (HasActorBegunPlay())
+	{
+		RefreshUpdateRateOptimizations();
+	}
+}
+
+void AISACharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* MantleSubsystem{GetWorld()->GetSubsystem<UISAMantleSubsystem>()})
+	{
+		MantleSubsystem->UnregisterCharacter(this);
+	}
+
+	if (auto* SignificanceSubsystem{GetWorld()->GetSubsystem<UISASignificanceSubsystem>()})
+	{
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
+	if (auto* CsvStatsSubsystem{GetWorld()->GetSubsystem<UISACsvStatsSubsystem>()})
+	{
+		CsvStatsSubsystem->UnregisterCharacter(this);
+	}
+
+	UnregisterAnimationBudget();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AISACharacterBase::SetForceGait(bool bWalk_Run, bool bRunSprint)
 {
-	bForceWalkRun = bWalk_Run;
-	bForceRunSprint = bRunSprint;
+	if (bForceWalkRun != bWalk_Run || bForceRunSprint != bRunSprint)
+	{
+		bForceWalkRun = bWalk_Run;
+		bForceRunSprint = bRunSprint;
+
+		GetISACharacterMovement()->MarkLocomotionDirty();
+	}
 }
 
 void AISACharacterBase::Jump()
 {
-	if (Stance == ISAStanceTags::Standing && !LocomotionAction.IsValid()
-		&& LocomotionMode == ISALocomotionModeTags::Grounded)
+	if (LocomotionState.Stance == EISAStance::Standing && LocomotionState.LocomotionAction == EISALocomotionAction::None
+		&& LocomotionState.LocomotionMode == EISALocomotionMode::Grounded)
 	{
 		Super::Jump();
 	}
@@ -111,24 +204,24 @@ void AISACharacterBase::OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHe
 {
 	Super::OnStartCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
 
-	SetStance(ISAStanceTags::Crouching);
+	SetStance(EISAStance::Crouching);
 }
 
 void AISACharacterBase::OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
 {
 	Super::OnEndCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
 
-	SetStance(ISAStanceTags::Standing);
+	SetStance(EISAStance::Standing);
 }
 
 bool AISACharacterBase::CanSprint() const
 {
-	if (!GetISACharacterMovement()->bHasInput || Stance != ISAStanceTags::Standing)
+	if (!GetISACharacterMovement()->bHasInput || LocomotionState.Stance != EISAStance::Standing)
 	{
 		return false;
 	}
 
-	if (GetISACharacterMovement()->bCanSprint)
+	if (GetISACharacterMovement()->WantsToSprint())
 	{
 		return true;
 	}
@@ -144,32 +237,59 @@ void AISACharacterBase::SetDebugCommand()
 
 void AISACharacterBase::PreRegisterAllComponents()
 {
-	Stance = DesiredStance;
-	Gait = DesiredGait;
+	LocomotionState.Stance = LocomotionState.DesiredStance;
+	LocomotionState.Gait = LocomotionState.DesiredGait;
+
+	RefreshReplicatedLocomotionState();
 	
 	Super::PreRegisterAllComponents();
 }
 
-FCollisionQueryParams AISACharacterBase::GetIgnoreCharacterParams() const
+void AISACharacterBase::PostRegisterAllComponents()
 {
-	// Ignore character when raycasting
-	FCollisionQueryParams Params;
+	Super::PostRegisterAllComponents();
 
-	TArray<AActor*> CharacterChildren;
-	GetAllChildActors(CharacterChildren);
-	Params.AddIgnoredActors(CharacterChildren);
-	Params.AddIgnoredActor(this);
+	//Child actor components spawn their actors while registering
+	InvalidateIgnoreCharacterParams();
+}
 
-	return Params;
+void AISACharacterBase::OnRep_AttachmentReplication()
+{
+	Super::OnRep_AttachmentReplication();
+
+	InvalidateIgnoreCharacterParams();
 }
 
-void AISACharacterBase::Tick(float DeltaTime)
+const FCollisionQueryParams& AISACharacterBase::GetIgnoreCharacterParams() const
 {
-	RefreshLocomotion(DeltaTime);
+	if (bIgnoreCharacterParamsDirty)
+	{
+		LLM_SCOPE_BYTAG(ISA_Scratch);
 
-	RefreshGait();
-	
-	Super::Tick(DeltaTime);
+		// Ignore character when raycasting
+		IgnoreCharacterParams = FCollisionQueryParams{SCENE_QUERY_STAT(ISAIgnoreCharacter), false, this};
+
+		TArray<AActor*> CharacterChildren;
+		GetAllChildActors(CharacterChildren);
+		IgnoreCharacterParams.AddIgnoredActors(CharacterChildren);
+
+		bIgnoreCharacterParamsDirty = false;
+	}
+
+	return IgnoreCharacterParams;
+}
+
+void AISACharacterBase::InvalidateIgnoreCharacterParams()
+{
+	bIgnoreCharacterParamsDirty = true;
+}
+
+void AISACharacterBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	//The owner predicts its own state, only the other connections need it
+	DOREPLIFETIME_CONDITION(ThisClass, ReplicatedLocomotionState, COND_SkipOwner);
 }
 
 void AISACharacterBase::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
@@ -178,114 +298,427 @@ void AISACharacterBase::OnMovementModeChanged(EMovementMode PreviousMovementMode
 	switch (GetCharacterMovement()->MovementMode)
 	{
 		case MOVE_Walking:
-			SetLocomotionMode(ISALocomotionModeTags::Grounded);
+			SetLocomotionMode(EISALocomotionMode::Grounded);
 			break;
 
 		case MOVE_Falling:
-			SetLocomotionMode(ISALocomotionModeTags::InAir);
+			SetLocomotionMode(EISALocomotionMode::InAir);
 			break;
 		
 		default:
-			SetLocomotionMode(FGameplayTag::EmptyTag);
+			SetLocomotionMode(EISALocomotionMode::None);
 			break;
 
 	}
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 }
 
-void AISACharacterBase::RefreshLocomotion(const float DeltaTime)
+void AISACharacterBase::MantleTrace()
+{
+	ISA_SCOPED_TIMER(MantleTrace);
+
+	MantleResult = {};
+
+	if (!GetISACharacterMovement()->IsMovingOnGround())
+	{
+		return;
+	}
+
+	if (MantleSettings->ProbeMode == EISAMantleProbeMode::OnJump)
+	{
+		ISAMantle::EvaluateMantle(*GetWorld(), MakeMantleQuery(), MantleResult);
+	}
+	else if (const auto* ProbedResult{GetProbedMantleResult()})
+	{
+		//The traces already ran in the background, just use the last result
+		MantleResult = *ProbedResult;
+
+		//The probe started a few frames ago, the mantle starts where the character is now
+		const FVector Location{GetActorLocation()};
+		MantleResult.VaultStartPos = FVector{Location.X, Location.Y, Location.Z - GetISACharacterMovement()->CapHH()};
+
+		MantleProbe.Reset();
+		BatchedMantleResultFrame = 0;
+	}
+
+	ISA_TRACE(MantleResult, *this, MantleResult, MantleSettings->ProbeMode != EISAMantleProbeMode::OnJump);
+
+	if (MantleResult.bCanMantle)
+	{
+		if (!HasAuthority())
+		{
+			ServerStartMantle(MantleResult.VaultStartPos, MantleResult.VaultMidPos, MantleResult.VaultEndPos,
+				MantleResult.MantleType, MantleResult.bCanWarp);
+		}
+
+		StartMantle();
+	}
+}
+
+void AISACharacterBase::ServerStartMantle_Implementation(const FVector_NetQuantize10& StartPos, const FVector_NetQuantize10& MidPos,
+	const FVector_NetQuantize10& EndPos, EISAMantleType MantleType, bool bCanWarp)
 {
-	GetISACharacterMovement()->Speed = UE_REAL_TO_FLOAT(GetISACharacterMovement()->Velocity.Size2D());
+	FMantleResult Proposal;
+	Proposal.MantleType = MantleType;
+	Proposal.VaultStartPos = StartPos;
+	Proposal.VaultMidPos = MidPos;
+	Proposal.VaultEndPos = EndPos;
+	Proposal.bCanWarp = bCanWarp;
+	Proposal.bCanMantle = true;
+
+	if (!GetISACharacterMovement()->IsMovingOnGround() || !ISAMantle::ValidateMantle(*GetWorld(), MakeMantleQuery(), Proposal))
+	{
+		ClientRejectMantle();
+		return;
+	}
+
+	MantleResult = Proposal;
+
+	StartMantle();
 }
 
-void AISACharacterBase::MantleTrace()
+void AISACharacterBase::ClientRejectMantle_Implementation()
 {
-	if (GetISACharacterMovement()->IsMovingOnGround())
+	//The server keeps the character where it was, the movement correction brings the client back
+	MantleResult = {};
+
+	if (LocomotionState.LocomotionAction == EISALocomotionAction::Mantling)
 	{
-		for (int i = 0; i < 3; i++)
+		StopAnimMontage(GetCurrentMontage());
+	}
+}
+
+void AISACharacterBase::StartMantle()
+{
+	UAnimMontage* Montage{MantleSettings->GetMontageForMantleType(MantleResult.MantleType)};
+
+	//Requested on BeginPlay, only missing in the first frames after spawning. Never wait for it
+	if (!IsValid(Montage))
+	{
+		return;
+	}
+
+	if (LocomotionState.LocomotionAction != EISALocomotionAction::None)
+	{
+		return;
+	}
+
+	const FRotator Rotation{GetActorRotation()};
+
+	MotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(MantleSettings->StartWarpTargetName, MantleResult.VaultStartPos, Rotation);
+	MotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(MantleSettings->MidWarpTargetName, MantleResult.VaultMidPos, Rotation);
+
+	if (MantleResult.bCanWarp)
+	{
+		MotionWarping->AddOrUpdateWarpTargetFromLocationAndRotation(MantleSettings->EndWarpTargetName, MantleResult.VaultEndPos, Rotation);
+	}
+	else
+	{
+		MotionWarping->RemoveWarpTarget(MantleSettings->EndWarpTargetName);
+	}
+
+	if (PlayAnimMontage(Montage) <= 0.f)
+	{
+		return;
+	}
+
+	//Flying lets the root motion move the capsule over the obstacle, the movement component switches back to walking when it ends
+	GetISACharacterMovement()->SetMovementMode(MOVE_Flying);
+
+	FOnMontageEnded EndDelegate;
+	EndDelegate.BindUObject(this, &ThisClass::OnMantleMontageEnded);
+	GetMesh()->GetAnimInstance()->Montage_SetEndDelegate(EndDelegate, Montage);
+
+	SetLocomotionAction(EISALocomotionAction::Mantling);
+
+	OnMantleStarted(Montage);
+}
+
+void AISACharacterBase::OnMantleMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+{
+	if (LocomotionState.LocomotionAction == EISALocomotionAction::Mantling)
+	{
+		SetLocomotionAction(EISALocomotionAction::None);
+	}
+
+	OnMantleEnded(bInterrupted);
+}
+
+const FMantleResult* AISACharacterBase::GetProbedMantleResult() const
+{
+	switch (MantleSettings->ProbeMode)
+	{
+	case EISAMantleProbeMode::Async:
+		return MantleProbe.GetResult(MantleSettings->MaxProbeResultAge);
+
+	case EISAMantleProbeMode::Batched:
+		if (BatchedMantleResultFrame != 0 && GFrameCounter - BatchedMantleResultFrame <= static_cast<uint64>(MantleSettings->MaxProbeResultAge))
 		{
-			FVector StartLoc = FVector{GetActorLocation().X, GetActorLocation().Y, GetActorLocation().Z + i * MantleSettings->TraceForwardStart};
-			FVector ForwardVector = GetActorForwardVector() * MantleSettings->ForwardTraceLength;
-			FVector EndLoc = StartLoc + ForwardVector;
-
-			TArray<AActor*> IngoreActors;
-			IngoreActors.Add(this);
-			
-			FHitResult HitResult;
-			
-			if (UKismetSystemLibrary::SphereTraceSingleForObjects(GetWorld(), StartLoc, EndLoc, 5, MantleSettings->ObjectTypes,
-				false, IngoreActors, EDrawDebugTrace::Type::Persistent, HitResult, true))
-			{
-				MantleSettings->VaultStartPos = FVector{GetActorLocation().X, GetActorLocation().Y, GetActorLocation().Z - ISACharacterMovementComponent->CapHH()};
-				
-				for (int f = 0; f < 6; f++)
-				{
-					FVector _ForwardVector = GetActorForwardVector() * (f * 50);
-					FVector _StartLoc = FVector{HitResult.Location.X, HitResult.Location.Y, HitResult.Location.Z + 100} + _ForwardVector;
-					FVector _EndLoc = _StartLoc - FVector{0,0,100};
-			
-					FHitResult _HitResult;
-			
-					if (UKismetSystemLibrary::SphereTraceSingleForObjects(GetWorld(), _StartLoc, _EndLoc, 5, MantleSettings->ObjectTypes,
-						false, IngoreActors, EDrawDebugTrace::Type::Persistent, _HitResult, true))
-					{
-						if (!_HitResult.bStartPenetrating)
-						{
-							MantleSettings->VaultMidPos = FVector{_HitResult.Location.X, _HitResult.Location.Y,
-								_HitResult.Location.Z - ISACharacterMovementComponent->CapHH() / 2};
-						}
-						else
-						{
-							MantleSettings->bCanWarp = false;
-							MantleSettings->VaultEndPos = {0,0,2000};
-							break;
-						}
-					}
-					else if (UKismetSystemLibrary::LineTraceSingleForObjects(GetWorld(), _HitResult.TraceStart + GetActorForwardVector() * 80,
-						(_HitResult.TraceStart + GetActorForwardVector() * 80) - FVector{0,0,1000}, MantleSettings->ObjectTypes,
-						false, IngoreActors, EDrawDebugTrace::Type::Persistent, _HitResult, true))
-					{
-						MantleSettings->VaultEndPos = _HitResult.Location;
-						break;
-					}
-				}
-				MantleSettings->bCanMantle = true;
-				
-				SetupMantle();
-			}
-			MantleSettings->bCanMantle = false;
+			return &BatchedMantleResult;
 		}
+		return nullptr;
+
+	default:
+		return nullptr;
 	}
-	else
+}
+
+bool AISACharacterBase::ShouldProbeMantle() const
+{
+	return bSignificanceAllowsMantleProbe && GetISACharacterMovement()->IsMovingOnGround() && GetISACharacterMovement()->bHasInput;
+}
+
+FISAMantleQuery AISACharacterBase::MakeMantleQuery() const
+{
+	//Every mantle evaluation starts from a query
+	ISA_INC_COUNTER(MantleProbes);
+
+	FISAMantleQuery Query;
+	Query.Location = GetActorLocation();
+	Query.Forward = GetActorForwardVector();
+	Query.CapsuleHalfHeight = GetISACharacterMovement()->CapHH();
+	Query.CapsuleRadius = GetISACharacterMovement()->CapR();
+	Query.IgnoredActor = this;
+	Query.Settings = MantleSettings;
+
+	return Query;
+}
+
+void AISACharacterBase::SetBatchedMantleResult(const FMantleResult& NewResult)
+{
+	BatchedMantleResult = NewResult;
+	BatchedMantleResultFrame = GFrameCounter;
+}
+
+void AISACharacterBase::UpdateSignificance(float Distance)
+{
+	const auto& SignificanceSettings{GeneralSettings->SignificanceSettings};
+
+	SignificanceDistance = Distance;
+
+	RefreshAnimationBudget();
+
+	if (SignificanceSettings.Tiers.IsEmpty())
+	{
+		return;
+	}
+
+	//The player's own character is always fully updated
+	const int32 NewTier{IsPlayerControlled() && IsLocallyControlled()
+		                    ? 0
+		                    : SignificanceSettings.SelectTier(Distance, FMath::Max(SignificanceTier, 0))};
+
+	if (NewTier != SignificanceTier)
+	{
+		SignificanceTier = NewTier;
+
+		ApplySignificanceTier(SignificanceSettings.Tiers[NewTier]);
+	}
+}
+
+void AISACharacterBase::ApplySignificanceTier(const FISASignificanceTier& Tier)
+{
+	//Simulated proxies smooth between server updates every frame and the moves of remote players arrive as server moves,
+	//only characters simulated here can update less often
+	const bool bCanThrottleMovement{GetLocalRole() == ROLE_Authority && GetRemoteRole() != ROLE_AutonomousProxy};
+	const FISASignificanceTier& MovementTier{bCanThrottleMovement ? Tier : GeneralSettings->SignificanceSettings.Tiers[0]};
+	const bool bThrottlesMovement{MovementTier.MovementTickInterval > 0.f};
+
+	GetISACharacterMovement()->SetComponentTickInterval(MovementTier.MovementTickInterval);
+	GetISACharacterMovement()->MaxSimulationIterations = MovementTier.MaxSimulationIterations;
+
+	//The budget allocator already throttles the mesh
+	if (!bUsesAnimationBudget)
+	{
+		GetMesh()->SetComponentTickInterval(Tier.AnimationTickInterval);
+		GetMesh()->VisibilityBasedAnimTickOption = Tier.bTickPoseWhenNotRendered
+			                                           ? DefaultVisibilityBasedAnimTickOption
+			                                           : EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+
+	PushComponent->SetComponentTickInterval(Tier.ComponentTickInterval);
+
+	//The async probe is advanced by the movement updates and needs them every frame to collect its sweeps
+	bSignificanceAllowsMantleProbe = Tier.bProbeMantle && !bThrottlesMovement;
+
+	if (!bSignificanceAllowsMantleProbe)
+	{
+		MantleProbe.Reset();
+	}
+}
+
+void AISACharacterBase::RegisterAnimationBudget()
+{
+	const auto& BudgetSettings{GeneralSettings->AnimationBudgetSettings};
+
+	RefreshUpdateRateOptimizations();
+
+	auto* BudgetedMesh{Cast<USkeletalMeshComponentBudgeted>(GetMesh())};
+	auto* BudgetAllocator{IAnimationBudgetAllocator::Get(GetWorld())};
+
+	if (!BudgetSettings.bUseAnimationBudget || BudgetedMesh == nullptr || BudgetAllocator == nullptr)
+	{
+		return;
+	}
+
+	//The allocator is shared by the world, the first character sets it up
+	if (!BudgetAllocator->GetEnabled())
+	{
+		FAnimationBudgetAllocatorParameters Parameters;
+		Parameters.BudgetInMs = BudgetSettings.BudgetInMs;
+
+		BudgetAllocator->SetParameters(Parameters);
+		BudgetAllocator->SetEnabled(true);
+	}
+
+	BudgetAllocator->RegisterComponent(BudgetedMesh);
+	bUsesAnimationBudget = true;
+
+	//Actions run montages that move the capsule, those must never be skipped
+	OnLocomotionActionChangedDelegate.AddWeakLambda(this, [this](AISACharacterBase&, EISALocomotionAction, EISALocomotionAction)
+	{
+		RefreshAnimationBudget();
+	});
+
+	RefreshAnimationBudget();
+}
+
+void AISACharacterBase::UnregisterAnimationBudget()
+{
+	if (!bUsesAnimationBudget)
+	{
+		return;
+	}
+
+	if (auto* BudgetAllocator{IAnimationBudgetAllocator::Get(GetWorld())})
+	{
+		BudgetAllocator->UnregisterComponent(CastChecked<USkeletalMeshComponentBudgeted>(GetMesh()));
+	}
+
+	bUsesAnimationBudget = false;
+}
+
+void AISACharacterBase::RefreshAnimationBudget()
+{
+	auto* BudgetAllocator{bUsesAnimationBudget ? IAnimationBudgetAllocator::Get(GetWorld()) : nullptr};
+
+	if (BudgetAllocator == nullptr)
+	{
+		return;
+	}
+
+	const bool bNeverSkip{LocomotionState.LocomotionAction != EISALocomotionAction::None || (IsPlayerControlled() && IsLocallyControlled())};
+	const float Significance{1.f / (1.f + SignificanceDistance / GeneralSettings->AnimationBudgetSettings.HalfSignificanceDistance)};
+
+	BudgetAllocator->SetComponentSignificance(CastChecked<USkeletalMeshComponentBudgeted>(GetMesh()), Significance, bNeverSkip, bNeverSkip, !bNeverSkip);
+}
+
+void AISACharacterBase::RefreshUpdateRateOptimizations()
+{
+	const bool bPlayerCharacter{IsPlayerControlled() && IsLocallyControlled()};
+
+	GetMesh()->bEnableUpdateRateOptimizations = bDefaultEnableUpdateRateOptimizations
+		|| (GeneralSettings->AnimationBudgetSettings.bEnableUpdateRateOptimizations && !bPlayerCharacter);
+}
+
+void AISACharacterBase::UpdateMantleProbe()
+{
+	if (MantleSettings->ProbeMode == EISAMantleProbeMode::Async && IsLocallyControlled())
 	{
-		MantleSettings->bCanMantle = false;
+		MantleProbe.Tick(*this);
+	}
+}
+
+void AISACharacterBase::PreloadAssetBundle(const UPrimaryDataAsset* Settings, FName Bundle)
+{
+	if (!IsValid(Settings) || AssetBundleHandles.Contains(Bundle))
+	{
+		return;
 	}
+
+	LLM_SCOPE_BYTAG(ISA_Montages);
+
+	//Null when the bundle is already loaded
+	AssetBundleHandles.Add(Bundle, UAssetManager::Get().LoadPrimaryAsset(Settings->GetPrimaryAssetId(), {Bundle}));
 }
 
-void AISACharacterBase::SetupMantle_Implementation()
+void AISACharacterBase::RefreshReplicatedLocomotionState()
 {
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	ReplicatedLocomotionState = ISALocomotionState::Pack(LocomotionState);
 }
 
-void AISACharacterBase::SetLocomotionMode(const FGameplayTag& NewLocomotionMode)
+void AISACharacterBase::OnRep_ReplicatedLocomotionState()
+{
+	//Take the whole state at once, the regular setters are skipped
+	//because stance and movement mode changes already arrive through the character replication
+	const auto PreviousState{LocomotionState};
+
+	LocomotionState = ISALocomotionState::Unpack(ReplicatedLocomotionState);
+
+	if (LocomotionState.LocomotionMode != PreviousState.LocomotionMode)
+	{
+		ISA_TRACE(LocomotionTransition, *this, PreviousState.LocomotionMode, LocomotionState.LocomotionMode);
+
+		OnLocomotionModeChangedDelegate.Broadcast(*this, PreviousState.LocomotionMode, LocomotionState.LocomotionMode);
+	}
+
+	if (LocomotionState.Stance != PreviousState.Stance)
+	{
+		ISA_TRACE(LocomotionTransition, *this, PreviousState.Stance, LocomotionState.Stance);
+
+		OnStanceChangedDelegate.Broadcast(*this, PreviousState.Stance, LocomotionState.Stance);
+	}
+
+	if (LocomotionState.Gait != PreviousState.Gait)
+	{
+		ISA_TRACE(LocomotionTransition, *this, PreviousState.Gait, LocomotionState.Gait);
+
+		OnGaitChanged(ISALocomotionState::ToTag(PreviousState.Gait));
+
+		OnGaitChangedDelegate.Broadcast(*this, PreviousState.Gait, LocomotionState.Gait);
+	}
+
+	if (LocomotionState.LocomotionAction != PreviousState.LocomotionAction)
+	{
+		ISA_TRACE(LocomotionTransition, *this, PreviousState.LocomotionAction, LocomotionState.LocomotionAction);
+
+		OnLocomotionActionChangedDelegate.Broadcast(*this, PreviousState.LocomotionAction, LocomotionState.LocomotionAction);
+	}
+}
+
+void AISACharacterBase::SetLocomotionMode(EISALocomotionMode NewLocomotionMode)
 {
 	//checks if the new mode is not the old one
-	if (LocomotionMode != NewLocomotionMode)
+	if (LocomotionState.LocomotionMode != NewLocomotionMode)
 	{
-		const auto PreviousLocomotionMode{ LocomotionMode };
+		const auto PreviousLocomotionMode{LocomotionState.LocomotionMode};
 
 		//apply locomotionmode
-		LocomotionMode = NewLocomotionMode;
+		LocomotionState.LocomotionMode = NewLocomotionMode;
+
+		RefreshReplicatedLocomotionState();
+
+		GetISACharacterMovement()->MarkLocomotionDirty();
+
+		ISA_TRACE(LocomotionTransition, *this, PreviousLocomotionMode, NewLocomotionMode);
+
+		OnLocomotionModeChangedDelegate.Broadcast(*this, PreviousLocomotionMode, NewLocomotionMode);
 
-		NotifyLocomotionModeChanged({ PreviousLocomotionMode });
+		NotifyLocomotionModeChanged(PreviousLocomotionMode);
 	}
 
 }
 
-void AISACharacterBase::NotifyLocomotionModeChanged(const FGameplayTag& PreviousLocomotionMode)
+void AISACharacterBase::NotifyLocomotionModeChanged(EISALocomotionMode PreviousLocomotionMode)
 {
 	ApplyDesiredStance();
 
-	if (LocomotionMode == ISALocomotionModeTags::Grounded && PreviousLocomotionMode == ISALocomotionModeTags::InAir)
+	if (LocomotionState.LocomotionMode == EISALocomotionMode::Grounded && PreviousLocomotionMode == EISALocomotionMode::InAir)
 	{
 			ISACharacterMovementComponent->BrakingFrictionFactor = ISACharacterMovementComponent->bHasInput 
 																									? GeneralSettings->HasInputBrakingFrictionFactor 
@@ -299,11 +732,18 @@ void AISACharacterBase::NotifyLocomotionModeChanged(const FGameplayTag& Previous
 }
 
 void AISACharacterBase::SetDesiredStance(const FGameplayTag& NewDesiredStance)
+{
+	SetDesiredStance(ISALocomotionState::ToStance(NewDesiredStance));
+}
+
+void AISACharacterBase::SetDesiredStance(EISAStance NewDesiredStance)
 {
 	//Sets the stance the player wants to be in. This essentially queues the stance for it to be applied
-	if (DesiredStance != NewDesiredStance)
+	if (LocomotionState.DesiredStance != NewDesiredStance)
 	{
-		DesiredStance = NewDesiredStance;
+		LocomotionState.DesiredStance = NewDesiredStance;
+
+		RefreshReplicatedLocomotionState();
 
 		ApplyDesiredStance();
 	}
@@ -311,61 +751,81 @@ void AISACharacterBase::SetDesiredStance(const FGameplayTag& NewDesiredStance)
 
 void AISACharacterBase::ApplyDesiredStance()
 {
-	if (!LocomotionAction.IsValid())
+	switch (LocomotionState.LocomotionAction)
 	{
-		if (LocomotionMode == ISALocomotionModeTags::Grounded)
+	case EISALocomotionAction::None:
+		if (LocomotionState.LocomotionMode == EISALocomotionMode::Grounded)
 		{
-			if (DesiredStance == ISAStanceTags::Standing)
+			if (LocomotionState.DesiredStance == EISAStance::Standing)
 			{
 				UnCrouch();
 			}
-			else if (DesiredStance == ISAStanceTags::Crouching)
+			else
 			{
 				Crouch();
 			}
 		}
-		else if (LocomotionMode == ISALocomotionModeTags::InAir)
+		else if (LocomotionState.LocomotionMode == EISALocomotionMode::InAir)
 		{
 			UnCrouch();
 		}
-	}
-	else if (LocomotionAction == ISALocomotionActionTags::Sliding)
-	{
+		break;
+
+	case EISALocomotionAction::Sliding:
 		Crouch();
+		break;
+
+	default:
+		break;
 	}
 }
 
-void AISACharacterBase::SetStance(const FGameplayTag& NewStance)
+void AISACharacterBase::SetStance(EISAStance NewStance)
 {
 	ISACharacterMovementComponent->SetStance(NewStance);
 
 	//Check if the current stance isnt the same as the new one
-	if (Stance != NewStance)
+	if (LocomotionState.Stance != NewStance)
 	{
-		//Set previous and current stance
-		const auto PreviousStance{Stance};
+		const auto PreviousStance{LocomotionState.Stance};
 
-		Stance = NewStance;
+		LocomotionState.Stance = NewStance;
+
+		RefreshReplicatedLocomotionState();
+
+		ISA_TRACE(LocomotionTransition, *this, PreviousStance, NewStance);
+
+		OnStanceChangedDelegate.Broadcast(*this, PreviousStance, NewStance);
 	}
 }
 
-void AISACharacterBase::SetDesiredGait(const FGameplayTag& NewDesiredGait)
+void AISACharacterBase::SetDesiredGait(EISAGait NewDesiredGait)
 {
-	if (DesiredGait != NewDesiredGait)
+	if (LocomotionState.DesiredGait != NewDesiredGait)
 	{
-		DesiredGait = NewDesiredGait;
+		LocomotionState.DesiredGait = NewDesiredGait;
+
+		RefreshReplicatedLocomotionState();
+
+		GetISACharacterMovement()->MarkLocomotionDirty();
 	}
 }
 
-void AISACharacterBase::SetGait(const FGameplayTag& NewGait)
+void AISACharacterBase::SetGait(EISAGait NewGait)
 {
-	if (Gait != NewGait)
+	if (LocomotionState.Gait != NewGait)
 	{
-		const auto PreviousGait{Gait};
+		const auto PreviousGait{LocomotionState.Gait};
+
+		LocomotionState.Gait = NewGait;
+
+		RefreshReplicatedLocomotionState();
 
-		Gait = NewGait;
+		ISA_TRACE(LocomotionTransition, *this, PreviousGait, NewGait);
 
-		OnGaitChanged(PreviousGait);
+		OnGaitChanged(ISALocomotionState::ToTag(PreviousGait));
+
+		OnGaitChangedDelegate.Broadcast(*this, PreviousGait, NewGait);
 	}
 }
 
@@ -373,7 +833,9 @@ void AISACharacterBase::OnGaitChanged_Implementation(const FGameplayTag& Previou
 
 void AISACharacterBase::RefreshGait()
 {
-	if (LocomotionMode != ISALocomotionModeTags::Grounded)
+	ISA_SCOPED_TIMER(RefreshGait);
+
+	if (LocomotionState.LocomotionMode != EISALocomotionMode::Grounded)
 	{
 		return;
 	}
@@ -385,72 +847,85 @@ void AISACharacterBase::RefreshGait()
 	SetGait(CalculateActualGait(MaxAllowedGait));
 }
 
-FGameplayTag AISACharacterBase::CalculateMaxAllowedGait() const
+EISAGait AISACharacterBase::CalculateMaxAllowedGait() const
 {
 	//This represents the maximum gait the character is currently allowed to be in and can be determined by 
 	//desired gait, stance etc (If you want to force the character to be in a Gait based on something you can do it here)
 	if (bForceWalkRun)
 	{
-		if (DesiredGait != ISAGaitTags::Sprinting)
+		if (LocomotionState.DesiredGait != EISAGait::Sprinting)
 		{
-			return DesiredGait;
+			return LocomotionState.DesiredGait;
 		}
 	}
 	if (bForceRunSprint)
 	{
 		if (CanSprint())
 		{
-			return ISAGaitTags::Sprinting;
+			return EISAGait::Sprinting;
 		}
-		return ISAGaitTags::Running;
+		return EISAGait::Running;
 	}
 
-	return ISAGaitTags::Walking;
+	return EISAGait::Walking;
 }
 
-FGameplayTag AISACharacterBase::CalculateActualGait(const FGameplayTag& MaxAllowedGait) const
+EISAGait AISACharacterBase::CalculateActualGait(EISAGait MaxAllowedGait) const
 {
 	//Calculates the actual gait the player is in, this can differ from the desired or max allowed gait,
 	//When sprinting to walking you'll only be in the walking gait when you decelerate enough to be considerd walking
-	
-	if (GetISACharacterMovement()->Speed < GeneralSettings->WalkSpeed + 10.f)
+	const auto Speed{GetISACharacterMovement()->Speed};
+
+	if (Speed < GeneralSettings->GetSpeedForGait(EISAGait::Walking, EISAStance::Standing) + 10.f)
 	{
-		return ISAGaitTags::Walking;
+		return EISAGait::Walking;
 	}
 
-	if (GetISACharacterMovement()->Speed < GeneralSettings->RunSpeed + 10.f || MaxAllowedGait != ISAGaitTags::Sprinting)
+	if (Speed < GeneralSettings->GetSpeedForGait(EISAGait::Running, EISAStance::Standing) + 10.f || MaxAllowedGait != EISAGait::Sprinting)
 	{
-		return ISAGaitTags::Running;
+		return EISAGait::Running;
 	}
 
-	return ISAGaitTags::Sprinting;
+	return EISAGait::Sprinting;
 }
 
 void AISACharacterBase::SetLocomotionAction(const FGameplayTag& NewLocomotionAction)
 {
-	if (LocomotionAction != NewLocomotionAction)
+	SetLocomotionAction(ISALocomotionState::ToLocomotionAction(NewLocomotionAction));
+}
+
+void AISACharacterBase::SetLocomotionAction(EISALocomotionAction NewLocomotionAction)
+{
+	if (LocomotionState.LocomotionAction != NewLocomotionAction)
 	{
-		const auto PreviousLocomotionAction{LocomotionAction};
+		const auto PreviousLocomotionAction{LocomotionState.LocomotionAction};
+
+		LocomotionState.LocomotionAction = NewLocomotionAction;
+
+		RefreshReplicatedLocomotionState();
+
+		ISA_TRACE(LocomotionTransition, *this, PreviousLocomotionAction, NewLocomotionAction);
 
-		LocomotionAction = NewLocomotionAction;
+		OnLocomotionActionChangedDelegate.Broadcast(*this, PreviousLocomotionAction, NewLocomotionAction);
 
 		NotifyLocomotionActionChanged(PreviousLocomotionAction);
 	}
 }
 
-void AISACharacterBase::NotifyLocomotionActionChanged(const FGameplayTag& PreviousLocomotionAction)
+void AISACharacterBase::NotifyLocomotionActionChanged(EISALocomotionAction PreviousLocomotionAction)
 {
 	ApplyDesiredStance();
 }
 
 UAnimMontage* AISACharacterBase::SelectRollMontage_Implementation()
 {
-	return GeneralSettings->SlideSettings.Montage;
+	//Null until the Slide bundle has loaded
+	return GeneralSettings->SlideSettings.Montage.Get();
 }
 
 void AISACharacterBase::TryStartSliding()
 {
-	if (LocomotionMode == ISALocomotionModeTags::Grounded)
+	if (LocomotionState.LocomotionMode == EISALocomotionMode::Grounded)
 	{
 		StartSliding();
 	}
@@ -458,16 +933,21 @@ void AISACharacterBase::TryStartSliding()
 
 bool AISACharacterBase::IsAllowedToSlide(const UAnimMontage* Montage) const
 {
-	return !LocomotionAction.IsValid() ||
-			   (!GetMesh()->GetAnimInstance()->Montage_IsPlaying(Montage)) ||
-					LocomotionMode == ISAGaitTags::Walking;
+	return LocomotionState.LocomotionAction == EISALocomotionAction::None ||
+			   !GetMesh()->GetAnimInstance()->Montage_IsPlaying(Montage);
 }
 
 void AISACharacterBase::StartSliding()
 {
 	auto* Montage{SelectRollMontage()};
 
-	if (!ensure(IsValid(Montage)) || !IsAllowedToSlide(Montage))
+	//Requested on BeginPlay, only missing in the first frames after spawning. Never wait for it
+	if (!IsValid(Montage))
+	{
+		return;
+	}
+
+	if (!IsAllowedToSlide(Montage))
 	{
 		return;
 	}
@@ -480,7 +960,7 @@ void AISACharacterBase::StartSlidingImplementation(UAnimMontage* Montage)
 	if (IsAllowedToSlide(Montage))// && GetMesh()->GetAnimInstance()->Montage_Play(Montage, 1))
 	{
 		PlayAnimMontage(Montage,1);
-		SetLocomotionAction(ISALocomotionActionTags::Sliding);
+		SetLocomotionAction(EISALocomotionAction::Sliding);
 	}
 }
 
@@ -524,7 +1004,7 @@ void AISACharacterBase::DisplayDebugStateInfo(const UCanvas* Canvas, const float
 
 	//Gets the LocomotionMode and converts it to Text
 	static const auto LocomotionModeText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, LocomotionMode), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, LocomotionMode), false))
 	};
 
 	//Display Text
@@ -532,7 +1012,7 @@ void AISACharacterBase::DisplayDebugStateInfo(const UCanvas* Canvas, const float
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
 	//Display the current State of the Tag
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(LocomotionMode).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetLocomotionMode()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	//Add Offset
@@ -540,61 +1020,61 @@ void AISACharacterBase::DisplayDebugStateInfo(const UCanvas* Canvas, const float
 
 	//Repeat of the previous steps
 	static const auto DesiredStanceText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, DesiredStance), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, DesiredStance), false))
 	};
 
 	Text.Text = DesiredStanceText;
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(DesiredStance).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetDesiredStance()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	VerticalLocation += RowOffset;
 
 	static const auto StanceText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, Stance), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, Stance), false))
 	};
 
 	Text.Text = StanceText;
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(Stance).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetStance()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	VerticalLocation += RowOffset;
 
 	static const auto DesiredGaitText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, DesiredGait), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, DesiredGait), false))
 	};
 
 	Text.Text = DesiredGaitText;
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(DesiredGait).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetDesiredGait()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	VerticalLocation += RowOffset;
 
 	static const auto GaitText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, Gait), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, Gait), false))
 	};
 
 	Text.Text = GaitText;
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(Gait).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetGait()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	VerticalLocation += RowOffset;
 
 	static const auto LocomotionActionText{
-		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(ThisClass, LocomotionAction), false))
+		FText::AsCultureInvariant(FName::NameToDisplayString(GET_MEMBER_NAME_STRING_CHECKED(FISALocomotionState, LocomotionAction), false))
 	};
 
 	Text.Text = LocomotionActionText;
 	Text.Draw(Canvas->Canvas, {HorizontalLocation, VerticalLocation});
 
-	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(LocomotionAction).ToString(), false));
+	Text.Text = FText::AsCultureInvariant(FName::NameToDisplayString(GetSimpleTagName(GetLocomotionAction()).ToString(), false));
 	Text.Draw(Canvas->Canvas, {HorizontalLocation + ColumnOffset, VerticalLocation});
 
 	VerticalLocation += RowOffset;
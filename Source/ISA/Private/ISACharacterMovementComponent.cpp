@@ -6,24 +6,154 @@
 #include "VectorUtil.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
+#include "Utility/ISAPlaneProfile.h"
+#include "Utility/ISAPlaneProfileSubsystem.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
 
 
+#pragma region Saved Move
+
+UISACharacterMovementComponent::FSavedMove_ISA::FSavedMove_ISA()
+{
+	Saved_bWantsToSprint = 0;
+	Saved_bForceWalkRun = 0;
+	Saved_bForceRunSprint = 0;
+}
+
+bool UISACharacterMovementComponent::FSavedMove_ISA::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	//Only combine moves when the movement intent did not change in between
+	const FSavedMove_ISA* NewISAMove = static_cast<FSavedMove_ISA*>(NewMove.Get());
+
+	if (Saved_bWantsToSprint != NewISAMove->Saved_bWantsToSprint || Saved_bForceWalkRun != NewISAMove->Saved_bForceWalkRun
+		|| Saved_bForceRunSprint != NewISAMove->Saved_bForceRunSprint || Saved_DesiredGait != NewISAMove->Saved_DesiredGait)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void UISACharacterMovementComponent::FSavedMove_ISA::Clear()
+{
+	Super::Clear();
+
+	Saved_bWantsToSprint = 0;
+	Saved_bForceWalkRun = 0;
+	Saved_bForceRunSprint = 0;
+	Saved_DesiredGait = EISAGait::Walking;
+}
+
+uint8 UISACharacterMovementComponent::FSavedMove_ISA::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (Saved_bWantsToSprint) Result |= FLAG_Custom_0;
+
+	return Result;
+}
+
+void UISACharacterMovementComponent::FSavedMove_ISA::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	//Capture the state of the movement component at the time of the move
+	const UISACharacterMovementComponent* CharacterMovement = Cast<UISACharacterMovementComponent>(C->GetCharacterMovement());
+
+	Saved_bWantsToSprint = CharacterMovement->bWantsToSprint;
+
+	const AISACharacterBase* Character = CastChecked<AISACharacterBase>(C);
+
+	Saved_bForceWalkRun = Character->bForceWalkRun;
+	Saved_bForceRunSprint = Character->bForceRunSprint;
+	Saved_DesiredGait = Character->GetLocomotionState().DesiredGait;
+}
+
+void UISACharacterMovementComponent::FSavedMove_ISA::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	//Restore the state of the movement component before a move gets replayed
+	UISACharacterMovementComponent* CharacterMovement = Cast<UISACharacterMovementComponent>(C->GetCharacterMovement());
+
+	CharacterMovement->SetWantsToSprint(Saved_bWantsToSprint);
+
+	AISACharacterBase* Character = CastChecked<AISACharacterBase>(C);
+
+	Character->SetForceGait(Saved_bForceWalkRun, Saved_bForceRunSprint);
+	Character->SetDesiredGait(Saved_DesiredGait);
+}
+
+UISACharacterMovementComponent::FNetworkPredictionData_Client_ISA::FNetworkPredictionData_Client_ISA(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr UISACharacterMovementComponent::FNetworkPredictionData_Client_ISA::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_ISA());
+}
+
+void UISACharacterMovementComponent::FISACharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_ISA& ISAMove = static_cast<const FSavedMove_ISA&>(ClientMove);
+
+	GaitIntent = static_cast<uint8>(ISAMove.Saved_DesiredGait) | ISAMove.Saved_bForceWalkRun << 2 | ISAMove.Saved_bForceRunSprint << 3;
+}
+
+bool UISACharacterMovementComponent::FISACharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	Ar.SerializeBits(&GaitIntent, 4);
+
+	return !Ar.IsError();
+}
+
+UISACharacterMovementComponent::FISACharacterNetworkMoveDataContainer::FISACharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &ISAMoveData[0];
+	PendingMoveData = &ISAMoveData[1];
+	OldMoveData = &ISAMoveData[2];
+}
+
+#pragma endregion
+
 UISACharacterMovementComponent::UISACharacterMovementComponent()
 {
 	//Init so player can crouch
 	NavAgentProps.bCanCrouch = true;
+
+	SetNetworkMoveDataContainer(ISANetworkMoveDataContainer);
 }
 
 #pragma region CMC
 
 void UISACharacterMovementComponent::InitializeComponent()
 {
+	LLM_SCOPE_BYTAG(ISA_Character);
+
 	Super::InitializeComponent();
 
 	//Sets character variable
 	ISACharacterBase = Cast<AISACharacterBase>(GetOwner());
 }
 
+void UISACharacterMovementComponent::BeginPlay()
+{
+	LLM_SCOPE_BYTAG(ISA_Character);
+
+	Super::BeginPlay();
+
+	if (const auto* PlaneProfileSubsystem{GetWorld()->GetSubsystem<UISAPlaneProfileSubsystem>()})
+	{
+		PlaneProfile = PlaneProfileSubsystem->GetProfile();
+	}
+}
+
 // Getters / Helpers
 bool UISACharacterMovementComponent::IsMovingOnGround() const
 {
@@ -66,6 +196,36 @@ float UISACharacterMovementComponent::GetMaxBrakingDeceleration() const
 			return -1.f;
 	}
 }
+FNetworkPredictionData_Client* UISACharacterMovementComponent::GetPredictionData_Client() const
+{
+	check(PawnOwner != nullptr)
+
+	if (ClientPredictionData == nullptr)
+	{
+		UISACharacterMovementComponent* MutableThis = const_cast<UISACharacterMovementComponent*>(this);
+
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_ISA(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UISACharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	SetWantsToSprint((Flags & FSavedMove_Character::FLAG_Custom_0) != 0);
+
+	//Only set while the server runs a client move, replayed moves get their intent from PrepMoveFor
+	const auto* MoveData{static_cast<const FISACharacterNetworkMoveData*>(GetCurrentNetworkMoveData())};
+
+	if (MoveData != nullptr && IsValid(ISACharacterBase))
+	{
+		ISACharacterBase->SetForceGait((MoveData->GaitIntent & 1 << 2) != 0, (MoveData->GaitIntent & 1 << 3) != 0);
+		ISACharacterBase->SetDesiredGait(static_cast<EISAGait>(FMath::Min<uint8>(MoveData->GaitIntent & 3, static_cast<uint8>(EISAGait::Sprinting))));
+	}
+}
+
 	#pragma region Movement Pipeline
 	void UISACharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
 	{
@@ -79,6 +239,7 @@ float UISACharacterMovementComponent::GetMaxBrakingDeceleration() const
 		}
 		else if (IsCustomMovementMode(CMOVE_Slide) && !bWantsToCrouch)
 		{
+			SlideExitReason = EISASlideExitReason::StoodUp;
 			SetMovementMode(MOVE_Walking);
 		}
 
@@ -117,9 +278,20 @@ float UISACharacterMovementComponent::GetMaxBrakingDeceleration() const
 	{
 		Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
 
+		ISA_INC_COUNTER(MovementUpdates);
+
+		const bool bHadInput{bHasInput};
+
 		SetupInputDirection(GetCurrentAcceleration() / GetMaxAcceleration());
+
+		RefreshLocomotion(bHadInput);
+
+		//Replayed moves must not advance the probe
+		if (IsValid(ISACharacterBase) && !CharacterOwner->bClientUpdating)
+		{
+			ISACharacterBase->UpdateMantleProbe();
+		}
 		
-		bPrevWantsToCrouch = bWantsToCrouch;
 	}
 
 	// Movement Event
@@ -138,6 +310,31 @@ float UISACharacterMovementComponent::GetMaxBrakingDeceleration() const
 	}
 	#pragma endregion
 
+void UISACharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult) const
+{
+	Super::FindFloor(CapsuleLocation, OutFloorResult, bCanUseCachedLocation, DownwardSweepResult);
+
+	//Other callers search floors at locations the character is not at
+	if (&OutFloorResult == &CurrentFloor)
+	{
+		CurrentFloorLocation = CapsuleLocation;
+		bHasCurrentFloorLocation = true;
+	}
+}
+
+void UISACharacterMovementComponent::AdjustFloorHeight()
+{
+	const bool bWasFresh{IsCurrentFloorFresh()};
+
+	//Moves the character onto CurrentFloor and updates its distance, so it stays fresh
+	Super::AdjustFloorHeight();
+
+	if (bWasFresh)
+	{
+		CurrentFloorLocation = UpdatedComponent->GetComponentLocation();
+	}
+}
+
 #pragma endregion
 
 #pragma region Slide
@@ -149,31 +346,67 @@ void UISACharacterMovementComponent::EnterSlide(EMovementMode PrevMode, ECustomM
 	bOrientRotationToMovement = false;
 	Velocity += Velocity.GetSafeNormal2D() * SlideEnterImpulse;
 	FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, true, NULL);
+
+	ISA_TRACE(SlideEnter, *CharacterOwner, Velocity.Size());
 }
 void UISACharacterMovementComponent::ExitSlide()
 {
 	//GEngine->AddOnScreenDebugMessage(1, 7.5f, FColor::Red, TEXT("Exit Slide"), true);
 	bWantsToCrouch = false;
 	bOrientRotationToMovement = true;
+
+	ISA_TRACE(SlideExit, *CharacterOwner, SlideExitReason, Velocity.Size());
+
+	SlideExitReason = EISASlideExitReason::MovementModeChanged;
 }
 
 bool UISACharacterMovementComponent::CanSlide() const
 {
-	if (Stance == ISAStanceTags::Crouching)
+	ISA_SCOPED_TIMER(CanSlide);
+
+	if (Stance != EISAStance::Crouching || Velocity.SizeSquared() <= FMath::Square(MinSlideSpeed))
+	{
+		return false;
+	}
+
+	//Checks if there is a surface to slide on, cheapest source first
+	const float MaxFloorDistance{CapHH() * 2.5f};
+
+	if (IsCurrentFloorFresh() && CurrentFloor.bBlockingHit)
+	{
+		return CurrentFloor.GetDistanceToFloor() + CapHH() <= MaxFloorDistance;
+	}
+
+	const FVector Start{UpdatedComponent->GetComponentLocation()};
+
+	if (FISAPlaneFloor Floor; PlaneProfile != nullptr && PlaneProfile->IsValidAt(Start))
 	{
-		//Checks if the player can Slide
-		FVector Start = UpdatedComponent->GetComponentLocation();
-		FVector End = Start + CapHH() * 2.5f * FVector::DownVector;
-		FName ProfileName = TEXT("BlockAll");
-		bool bValidSurface = GetWorld()->LineTraceTestByProfile(Start, End, ProfileName, ISACharacterBase->GetIgnoreCharacterParams());
-		bool bEnoughSpeed = Velocity.SizeSquared() > pow(MinSlideSpeed, 2);
-		return bValidSurface && bEnoughSpeed;
+		return PlaneProfile->FindFloor(Start, MaxFloorDistance, Floor);
 	}
-	return false;
+
+	const FVector End{Start + MaxFloorDistance * FVector::DownVector};
+
+	ISA_INC_PHYSICS_QUERY(Slide);
+
+	return GetWorld()->LineTraceTestByProfile(Start, End, ISAPlaneProfile::CollisionProfileName, ISACharacterBase->GetIgnoreCharacterParams());
+}
+
+bool UISACharacterMovementComponent::IsCurrentFloorFresh() const
+{
+	return bHasCurrentFloorLocation && CurrentFloorLocation == UpdatedComponent->GetComponentLocation();
+}
+
+void UISACharacterMovementComponent::SetCurrentFloor(const FFindFloorResult& NewFloor)
+{
+	CurrentFloor = NewFloor;
+	CurrentFloorLocation = UpdatedComponent->GetComponentLocation();
+	bHasCurrentFloorLocation = true;
 }
 
 void UISACharacterMovementComponent::PhysSlide(float deltaTime, int32 Iterations)
 {
+	ISA_SCOPED_TIMER(PhysSlide);
+
 	if (deltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -182,6 +415,7 @@ void UISACharacterMovementComponent::PhysSlide(float deltaTime, int32 Iterations
 	if (!CanSlide())
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Yellow, TEXT("Cant slide"));
+		SlideExitReason = EISASlideExitReason::CanSlideFailed;
 		SetMovementMode(MOVE_Walking);
 		StartNewPhysics(deltaTime, Iterations);
 		return;
@@ -196,6 +430,7 @@ void UISACharacterMovementComponent::PhysSlide(float deltaTime, int32 Iterations
 	while ( (remainingTime >= MIN_TICK_TIME) && (Iterations < MaxSimulationIterations) && CharacterOwner && (CharacterOwner->Controller || bRunPhysicsWithNoController || (CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)) )
 	{
 		//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Yellow, TEXT("EnterWhile"));
+		ISA_INC_COUNTER(SlideIterations);
 		Iterations++;
 		bJustTeleported = false;
 		const float timeTick = GetSimulationTimeStep(remainingTime, Iterations);
@@ -213,7 +448,7 @@ void UISACharacterMovementComponent::PhysSlide(float deltaTime, int32 Iterations
 
 		FVector SlopeForce = CurrentFloor.HitResult.Normal;
 		SlopeForce.Z = 0.f;
-		Velocity += SlopeForce * SlideGravityForce * deltaTime;
+		Velocity += SlopeForce * SlideGravityForce * timeTick;
 		
 		Acceleration = Acceleration.ProjectOnTo(UpdatedComponent->GetRightVector().GetSafeNormal2D());
 
@@ -259,7 +494,7 @@ void UISACharacterMovementComponent::PhysSlide(float deltaTime, int32 Iterations
 		if (StepDownResult.bComputedFloor)
 		{
 			//GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Yellow, TEXT("CurrentFloor"));
-			CurrentFloor = StepDownResult.FloorResult;
+			SetCurrentFloor(StepDownResult.FloorResult);
 		}
 		else
 		{
@@ -380,17 +615,34 @@ void UISACharacterMovementComponent::SetupInputDirection(FVector NewInputDirecti
 	bHasInput = NewInputDirection.GetSafeNormal().SizeSquared() > UE_KINDA_SMALL_NUMBER;
 }
 
-void UISACharacterMovementComponent::SetStance(const FGameplayTag& NewStance)
+void UISACharacterMovementComponent::SetWantsToSprint(bool bNewWantsToSprint)
+{
+	if (bWantsToSprint != bNewWantsToSprint)
+	{
+		bWantsToSprint = bNewWantsToSprint;
+
+		MarkLocomotionDirty();
+	}
+}
+
+bool UISACharacterMovementComponent::WantsToSprint() const
+{
+	return bWantsToSprint;
+}
+
+void UISACharacterMovementComponent::SetStance(EISAStance NewStance)
 {
 	if (Stance != NewStance)
 	{
 		Stance = NewStance;
 
 		RefreshMaxWalkSpeed();
+
+		MarkLocomotionDirty();
 	}
 }
 
-void UISACharacterMovementComponent::SetMaxAllowedGait(const FGameplayTag& NewMaxAllowedGait)
+void UISACharacterMovementComponent::SetMaxAllowedGait(EISAGait NewMaxAllowedGait)
 {
 	if (MaxAllowedGait != NewMaxAllowedGait)
 	{
@@ -400,6 +652,33 @@ void UISACharacterMovementComponent::SetMaxAllowedGait(const FGameplayTag& NewMa
 	}
 }
 
+void UISACharacterMovementComponent::MarkLocomotionDirty()
+{
+	bLocomotionDirty = true;
+}
+
+void UISACharacterMovementComponent::RefreshLocomotion(bool bHadInput)
+{
+	const float NewSpeed{UE_REAL_TO_FLOAT(Velocity.Size2D())};
+
+	if (NewSpeed != Speed || bHasInput != bHadInput)
+	{
+		Speed = NewSpeed;
+
+		bLocomotionDirty = true;
+	}
+
+	//Simulated proxies receive their gait through the replicated state
+	if (!bLocomotionDirty || !IsValid(ISACharacterBase) || CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return;
+	}
+
+	bLocomotionDirty = false;
+
+	ISACharacterBase->RefreshGait();
+}
+
 void UISACharacterMovementComponent::RefreshMaxWalkSpeed()
 {
 	MaxWalkSpeed = Settings->GetSpeedForGait(MaxAllowedGait, Stance);
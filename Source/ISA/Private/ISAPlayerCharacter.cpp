@@ -9,6 +9,8 @@
 #include "Interactibles/ISAInteractableInterface.h"
 #include "Interactibles/ISAPushComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
 
 #pragma region Handle Input
 
@@ -90,22 +92,22 @@ void AISAPlayerCharacter::Input_OnSprint(const FInputActionValue& ActionValue)
 	//UE_LOG(LogTemp, Warning, TEXT("%s"), ActionValue.Get<bool>() ? TEXT("True") : TEXT("False"));
 	if (bForceWalkRun)
 	{
-		SetDesiredGait(ActionValue.Get<bool>() ? ISAGaitTags::Running : ISAGaitTags::Walking);
+		SetDesiredGait(ActionValue.Get<bool>() ? EISAGait::Running : EISAGait::Walking);
 	}
 	else if (bForceRunSprint)
 	{
-		SetDesiredGait(ActionValue.Get<bool>() ? ISAGaitTags::Sprinting : ISAGaitTags::Running);
+		SetDesiredGait(ActionValue.Get<bool>() ? EISAGait::Sprinting : EISAGait::Running);
 	}
-	GetISACharacterMovement()->bCanSprint = ActionValue.Get<bool>();
+	GetISACharacterMovement()->SetWantsToSprint(ActionValue.Get<bool>());
 }
 
 void AISAPlayerCharacter::Input_OnJump(const FInputActionValue& ActionValue)
 {
 	if (ActionValue.Get<bool>() && !PushComponent->IsPushingObject())
 	{
-		if (GetStance() == ISAStanceTags::Crouching)
+		if (LocomotionState.Stance == EISAStance::Crouching)
 		{
-			SetDesiredStance(ISAStanceTags::Standing);
+			SetDesiredStance(EISAStance::Standing);
 			return;	
 		}
 		if (CanMantle())
@@ -125,22 +127,26 @@ void AISAPlayerCharacter::Input_OnCrouch()
 {
 	if (!PushComponent->IsPushingObject())
 	{
-		if (GetDesiredStance() == ISAStanceTags::Standing)
+		if (LocomotionState.DesiredStance == EISAStance::Standing)
 		{
-			SetDesiredStance(ISAStanceTags::Crouching);
+			SetDesiredStance(EISAStance::Crouching);
 			//TryStartSliding();
 		}
-		else if (GetDesiredStance() == ISAStanceTags::Crouching)
+		else if (LocomotionState.DesiredStance == EISAStance::Crouching)
 		{
-			SetDesiredStance(ISAStanceTags::Standing);
+			SetDesiredStance(EISAStance::Standing);
 		}
 	}
 }
 
 void AISAPlayerCharacter::Input_OnInteract()
 {
+	ISA_SCOPED_TIMER(Interact);
+
 	if (!PushComponent->IsPushingObject())
 	{
+		LLM_SCOPE_BYTAG(ISA_Scratch);
+
 		FVector Center = GetActorLocation();
 		Center.Z -= ISACharacterMovementComponent->CapHH();
 
@@ -148,9 +154,13 @@ void AISAPlayerCharacter::Input_OnInteract()
 		IngoreActors.Add(this);
 
 		TArray<AActor*> OutActors;
+
+		ISA_INC_PHYSICS_QUERY(Interact);
 		
 		UKismetSystemLibrary::SphereOverlapActors(GetWorld(), Center, PushComponent->PushRange, ObjectTypes, nullptr, IngoreActors, OutActors);
 
+		ISA_INC_COUNTER_BY(InteractableCandidates, OutActors.Num());
+
 		for (auto Actor : OutActors)
 		{
 			IISAInteractableInterface* TheInterface = Cast<IISAInteractableInterface>(Actor);
@@ -170,7 +180,7 @@ void AISAPlayerCharacter::Input_OnInteract()
 
 bool AISAPlayerCharacter::CanMantle()
 {
-	return LocomotionMode == ISALocomotionModeTags::Grounded;
+	return LocomotionState.LocomotionMode == EISALocomotionMode::Grounded;
 }
 
 #pragma endregion 
@@ -4,10 +4,13 @@
 #include "Interactibles/ISADoorBase.h"
 
 #include "Components/BoxComponent.h"
+#include "Utility/ISAMemory.h"
 
 // Sets default values
 AISADoorBase::AISADoorBase()
 {
+	LLM_SCOPE_BYTAG(ISA_Interactables);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = false;
 
@@ -39,6 +42,11 @@ void AISADoorBase::BPInteracted_Implementation()
 {
 }
 
+void AISADoorBase::SetWarpTransform(const FTransform& NewWarpTransform)
+{
+	WarpTransform = NewWarpTransform;
+}
+
 
 
 
@@ -3,9 +3,12 @@
 
 #include "Interactibles/ISAPushComponent.h"
 
+#include "ISACharacterBase.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
+#include "Utility/ISATrace.h"
 
 
 // Sets default values for this component's properties
@@ -19,10 +22,37 @@ UISAPushComponent::UISAPushComponent()
 // Called when the game starts
 void UISAPushComponent::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(ISA_Character);
+
 	Super::BeginPlay();
 
-	Player = UGameplayStatics::GetPlayerController(GetWorld(), 0)->GetCharacter();
+	//Every character pushes with its own component, player controlled or not
+	Player = Cast<ACharacter>(GetOwner());
 	SetComponentTickEnabled(false);
+
+	//A push can't continue once the character leaves the ground
+	if (auto* ISACharacter{Cast<AISACharacterBase>(GetOwner())})
+	{
+		ISACharacter->OnLocomotionModeChangedDelegate.AddUObject(this, &ThisClass::OnLocomotionModeChanged);
+	}
+}
+
+void UISAPushComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto* ISACharacter{Cast<AISACharacterBase>(GetOwner())})
+	{
+		ISACharacter->OnLocomotionModeChangedDelegate.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UISAPushComponent::OnLocomotionModeChanged(AISACharacterBase& Character, EISALocomotionMode PreviousLocomotionMode, EISALocomotionMode NewLocomotionMode)
+{
+	if (NewLocomotionMode != EISALocomotionMode::Grounded && IsPushingObject())
+	{
+		EndPush();
+	}
 }
 
 
@@ -31,6 +61,8 @@ void UISAPushComponent::TickComponent(float DeltaTime, ELevelTick TickType,
                                       FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ISA_SCOPED_TIMER(PushTick);
 	
 	CurrentPushable->AddActorWorldOffset(GetOwner()->GetActorForwardVector() * PushSpeed * DeltaTime);
 	
@@ -43,23 +75,37 @@ void UISAPushComponent::BeginPush(AISAPushableBase* Pushable)
 		CurrentPushable = Pushable;
 		const FAttachmentTransformRules Rules(EAttachmentRule::KeepWorld, EAttachmentRule::KeepWorld, EAttachmentRule::KeepWorld, true);
 		Player->AttachToActor(CurrentPushable, Rules);
+		InvalidatePlayerQueryParams();
 		Player->GetCharacterMovement()->SetPlaneConstraintEnabled(true);
 		Player->GetCharacterMovement()->SetPlaneConstraintNormal(Player->GetActorRightVector());
 		Player->GetCharacterMovement()->bOrientRotationToMovement = false;
 		SetComponentTickEnabled(true);
+
+		ISA_TRACE(Push, *Player, CurrentPushable, true);
 	}
 }
 
 void UISAPushComponent::EndPush()
 {
+	ISA_TRACE(Push, *Player, CurrentPushable, false);
+
 	CurrentPushable = {};
 	const FDetachmentTransformRules Rules(EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld, EDetachmentRule::KeepWorld, false);
 	Player->DetachFromActor(Rules);
+	InvalidatePlayerQueryParams();
 	Player->GetCharacterMovement()->SetPlaneConstraintEnabled(false);
 	Player->GetCharacterMovement()->bOrientRotationToMovement = true;
 	SetComponentTickEnabled(false);
 }
 
+void UISAPushComponent::InvalidatePlayerQueryParams() const
+{
+	if (auto* ISAPlayer{Cast<AISACharacterBase>(Player)})
+	{
+		ISAPlayer->InvalidateIgnoreCharacterParams();
+	}
+}
+
 bool UISAPushComponent::IsPushingObject() const
 {
 	return IsValid(CurrentPushable);
@@ -10,10 +10,14 @@
 #include "Components/CapsuleComponent.h"
 #include "Interactibles/ISAPushComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
 
 // Sets default values
 AISAPushableBase::AISAPushableBase()
 {
+	LLM_SCOPE_BYTAG(ISA_Interactables);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -25,6 +29,8 @@ AISAPushableBase::AISAPushableBase()
 // Called when the game starts or when spawned
 void AISAPushableBase::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(ISA_Interactables);
+
 	Super::BeginPlay();
 	
 }
@@ -42,6 +48,11 @@ void AISAPushableBase::OnInteracted(AISACharacterBase* Player)
 	HandleInteraction(Player);
 }
 
+void AISAPushableBase::SetPushTransforms(const TArray<FTransform>& NewPushTransforms)
+{
+	PushTransforms = NewPushTransforms;
+}
+
 void AISAPushableBase::HandleInteraction(AISACharacterBase* Player)
 {
 	// Checks if pushcomponent is attached to the player
@@ -64,11 +75,14 @@ void AISAPushableBase::HandleInteraction(AISACharacterBase* Player)
 			IgnoreActors.Add(this);
 
 			// trace for the pushable box
+			ISA_INC_PHYSICS_QUERY(Push);
 			UKismetSystemLibrary::CapsuleTraceSingle(GetWorld(), Start, End, Radius, HalfHeight, UEngineTypes::ConvertToTraceType(ECC_Visibility),
 			false, IgnoreActors, EDrawDebugTrace::Type::None, HitResult, true, FColor::Red, FColor::Green, 5);
 
 			if (!HitResult.bStartPenetrating && Player->GetISACharacterMovement()->GetWalkableFloorZ() < HitResult.ImpactNormal.Z)
 			{
+				ISA_INC_PHYSICS_QUERY(Push);
+
 				if (!UKismetSystemLibrary::LineTraceSingle(GetWorld(), GetActorLocation(), CurrentCharacterTransform.GetLocation(), UEngineTypes::ConvertToTraceType(ECC_Visibility),
 						false, TArray<AActor*>(), EDrawDebugTrace::Type::None, HitResult, true))
 				{
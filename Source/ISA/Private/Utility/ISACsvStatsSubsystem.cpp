@@ -0,0 +1,70 @@
+#include "Utility/ISACsvStatsSubsystem.h"
+
+#include "ISACharacterBase.h"
+#include "ISACharacterMovementComponent.h"
+#include "Interactibles/ISAPushComponent.h"
+#include "Utility/ISAProfiling.h"
+
+void UISACsvStatsSubsystem::RegisterCharacter(AISACharacterBase* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UISACsvStatsSubsystem::UnregisterCharacter(AISACharacterBase* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+bool UISACsvStatsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return CSV_PROFILER && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UISACsvStatsSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if CSV_PROFILER
+	//Walks every character, so only while something is recorded
+	if (!FCsvProfiler::Get()->IsCapturing())
+	{
+		return;
+	}
+
+	int32 GroundedCount{0};
+	int32 InAirCount{0};
+	int32 SlidingCount{0};
+	int32 MantlingCount{0};
+	int32 PushingCount{0};
+
+	for (const AISACharacterBase* Character : Characters)
+	{
+		if (!IsValid(Character))
+		{
+			continue;
+		}
+
+		const FISALocomotionState& LocomotionState{Character->GetLocomotionState()};
+
+		GroundedCount += LocomotionState.LocomotionMode == EISALocomotionMode::Grounded ? 1 : 0;
+		InAirCount += LocomotionState.LocomotionMode == EISALocomotionMode::InAir ? 1 : 0;
+		MantlingCount += LocomotionState.LocomotionAction == EISALocomotionAction::Mantling ? 1 : 0;
+
+		//The slide movement mode, the slide action only covers the montage
+		SlidingCount += Character->GetISACharacterMovement()->IsCustomMovementMode(CMOVE_Slide) ? 1 : 0;
+		PushingCount += Character->GetPushComponent()->IsPushingObject() ? 1 : 0;
+	}
+
+	CSV_CUSTOM_STAT(ISA, Characters, Characters.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ISA, CharactersGrounded, GroundedCount, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ISA, CharactersInAir, InAirCount, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ISA, CharactersSliding, SlidingCount, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ISA, CharactersMantling, MantlingCount, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ISA, CharactersPushing, PushingCount, ECsvCustomStatOp::Set);
+#endif
+}
+
+TStatId UISACsvStatsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UISACsvStatsSubsystem, STATGROUP_Tickables);
+}
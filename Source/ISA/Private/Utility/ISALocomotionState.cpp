@@ -0,0 +1,107 @@
+#include "Utility/ISALocomotionState.h"
+
+namespace ISALocomotionState
+{
+	EISALocomotionMode ToLocomotionMode(const FGameplayTag& Tag)
+	{
+		if (Tag == ISALocomotionModeTags::Grounded)
+		{
+			return EISALocomotionMode::Grounded;
+		}
+
+		if (Tag == ISALocomotionModeTags::InAir)
+		{
+			return EISALocomotionMode::InAir;
+		}
+
+		return EISALocomotionMode::None;
+	}
+
+	EISAStance ToStance(const FGameplayTag& Tag)
+	{
+		return Tag == ISAStanceTags::Crouching ? EISAStance::Crouching : EISAStance::Standing;
+	}
+
+	EISAGait ToGait(const FGameplayTag& Tag)
+	{
+		if (Tag == ISAGaitTags::Running)
+		{
+			return EISAGait::Running;
+		}
+
+		if (Tag == ISAGaitTags::Sprinting)
+		{
+			return EISAGait::Sprinting;
+		}
+
+		return EISAGait::Walking;
+	}
+
+	EISALocomotionAction ToLocomotionAction(const FGameplayTag& Tag)
+	{
+		if (Tag == ISALocomotionActionTags::Mantling)
+		{
+			return EISALocomotionAction::Mantling;
+		}
+
+		if (Tag == ISALocomotionActionTags::Sliding)
+		{
+			return EISALocomotionAction::Sliding;
+		}
+
+		return EISALocomotionAction::None;
+	}
+
+	//The native tags are registered during static init, so the lookup tables are built on first use
+	const FGameplayTag& ToTag(EISALocomotionMode LocomotionMode)
+	{
+		static const FGameplayTag Tags[]{FGameplayTag::EmptyTag, ISALocomotionModeTags::Grounded, ISALocomotionModeTags::InAir};
+
+		return Tags[static_cast<uint8>(LocomotionMode)];
+	}
+
+	const FGameplayTag& ToTag(EISAStance Stance)
+	{
+		static const FGameplayTag Tags[]{ISAStanceTags::Standing, ISAStanceTags::Crouching};
+
+		return Tags[static_cast<uint8>(Stance)];
+	}
+
+	const FGameplayTag& ToTag(EISAGait Gait)
+	{
+		static const FGameplayTag Tags[]{ISAGaitTags::Walking, ISAGaitTags::Running, ISAGaitTags::Sprinting};
+
+		return Tags[static_cast<uint8>(Gait)];
+	}
+
+	const FGameplayTag& ToTag(EISALocomotionAction LocomotionAction)
+	{
+		static const FGameplayTag Tags[]{FGameplayTag::EmptyTag, ISALocomotionActionTags::Mantling, ISALocomotionActionTags::Sliding};
+
+		return Tags[static_cast<uint8>(LocomotionAction)];
+	}
+
+	uint16 Pack(const FISALocomotionState& State)
+	{
+		return static_cast<uint16>(State.LocomotionMode) << LocomotionModeShift
+			| static_cast<uint16>(State.DesiredStance) << DesiredStanceShift
+			| static_cast<uint16>(State.Stance) << StanceShift
+			| static_cast<uint16>(State.DesiredGait) << DesiredGaitShift
+			| static_cast<uint16>(State.Gait) << GaitShift
+			| static_cast<uint16>(State.LocomotionAction) << LocomotionActionShift;
+	}
+
+	FISALocomotionState Unpack(uint16 PackedState)
+	{
+		//Out of range values are clamped so a corrupt word can never index past the tag tables
+		FISALocomotionState State;
+		State.LocomotionMode = static_cast<EISALocomotionMode>(FMath::Min(PackedState >> LocomotionModeShift & 0x3, 2));
+		State.DesiredStance = static_cast<EISAStance>(PackedState >> DesiredStanceShift & 0x1);
+		State.Stance = static_cast<EISAStance>(PackedState >> StanceShift & 0x1);
+		State.DesiredGait = static_cast<EISAGait>(FMath::Min(PackedState >> DesiredGaitShift & 0x3, 2));
+		State.Gait = static_cast<EISAGait>(FMath::Min(PackedState >> GaitShift & 0x3, 2));
+		State.LocomotionAction = static_cast<EISALocomotionAction>(FMath::Min(PackedState >> LocomotionActionShift & 0x3, 2));
+
+		return State;
+	}
+}
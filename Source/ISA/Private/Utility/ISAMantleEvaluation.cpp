@@ -0,0 +1,231 @@
+#include "Utility/ISAMantleEvaluation.h"
+
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "Utility/ISAProfiling.h"
+
+namespace
+{
+	//Minimal walkable normal for the top of an obstacle
+	constexpr float MinTopNormalZ{0.7f};
+
+	float GetFeetZ(const FISAMantleQuery& Query)
+	{
+		return Query.Location.Z - Query.CapsuleHalfHeight;
+	}
+
+	bool RunSweep(const UWorld& World, const FISAMantleQuery& Query, const FISAMantleSweep& MantleSweep, FHitResult& OutHit)
+	{
+		ISA_INC_PHYSICS_QUERY(Mantle);
+
+		const bool bHit{World.SweepSingleByObjectType(OutHit, MantleSweep.Start, MantleSweep.End, FQuat::Identity,
+			ISAMantle::MakeObjectQueryParams(*Query.Settings), MantleSweep.Shape, ISAMantle::MakeQueryParams(Query))};
+
+		ISAMantle::DrawSweep(World, MantleSweep, bHit, Query.Settings->DebugTraceType);
+
+		return bHit;
+	}
+}
+
+namespace ISAMantle
+{
+	FCollisionObjectQueryParams MakeObjectQueryParams(const UMantleSettings& Settings)
+	{
+		FCollisionObjectQueryParams ObjectParams;
+
+		for (const auto ObjectType : Settings.ObjectTypes)
+		{
+			ObjectParams.AddObjectTypesToQuery(UEngineTypes::ConvertToCollisionChannel(ObjectType));
+		}
+
+		return ObjectParams;
+	}
+
+	FCollisionQueryParams MakeQueryParams(const FISAMantleQuery& Query)
+	{
+		return FCollisionQueryParams{SCENE_QUERY_STAT(ISAMantleTrace), false, Query.IgnoredActor};
+	}
+
+	FISAMantleSweep MakeForwardSweep(const FISAMantleQuery& Query)
+	{
+		const UMantleSettings& Settings{*Query.Settings};
+		const float HalfHeight{FMath::Max((Settings.HighMantleMaxHeight - Settings.MinMantleHeight) / 2, Settings.TraceRadius)};
+
+		FISAMantleSweep Sweep;
+		Sweep.Start = FVector{Query.Location.X, Query.Location.Y, GetFeetZ(Query) + Settings.MinMantleHeight + HalfHeight};
+		Sweep.End = Sweep.Start + Query.Forward * Settings.ForwardTraceLength;
+		Sweep.Shape = FCollisionShape::MakeCapsule(Settings.TraceRadius, HalfHeight);
+
+		return Sweep;
+	}
+
+	FISAMantleSweep MakeTopSweep(const FISAMantleQuery& Query, const FHitResult& ForwardHit)
+	{
+		const UMantleSettings& Settings{*Query.Settings};
+		const FVector Inset{ForwardHit.ImpactPoint + Query.Forward * (Settings.TraceRadius * 2)};
+
+		FISAMantleSweep Sweep;
+		Sweep.Start = FVector{Inset.X, Inset.Y, GetFeetZ(Query) + Settings.HighMantleMaxHeight + Settings.TraceRadius};
+		Sweep.End = FVector{Inset.X, Inset.Y, GetFeetZ(Query) + Settings.MinMantleHeight};
+		Sweep.Shape = FCollisionShape::MakeSphere(Settings.TraceRadius);
+
+		return Sweep;
+	}
+
+	bool ClassifyTop(const FISAMantleQuery& Query, const FHitResult& TopHit, FMantleResult& OutResult)
+	{
+		const UMantleSettings& Settings{*Query.Settings};
+
+		//Starting inside the obstacle means it is higher than HighMantleMaxHeight
+		if (!TopHit.bBlockingHit || TopHit.bStartPenetrating || TopHit.ImpactNormal.Z < MinTopNormalZ)
+		{
+			OutResult.MantleType = EISAMantleType::NoMantle;
+			return false;
+		}
+
+		const float Height{UE_REAL_TO_FLOAT(TopHit.ImpactPoint.Z) - GetFeetZ(Query)};
+
+		OutResult.MantleType = Height <= Settings.LowMantleMaxHeight ? EISAMantleType::MantleLow : EISAMantleType::MantleHigh;
+		OutResult.VaultStartPos = FVector{Query.Location.X, Query.Location.Y, GetFeetZ(Query)};
+		OutResult.VaultMidPos = TopHit.Location - FVector{0, 0, Query.CapsuleHalfHeight / 2};
+
+		return true;
+	}
+
+	FISAMantleSweep MakeLandingSweep(const FISAMantleQuery& Query, const FHitResult& ForwardHit, const FHitResult& TopHit)
+	{
+		const UMantleSettings& Settings{*Query.Settings};
+		const FVector Behind{ForwardHit.ImpactPoint + Query.Forward * (Settings.MaxVaultDepth + Query.CapsuleRadius)};
+		const float StartZ{UE_REAL_TO_FLOAT(TopHit.ImpactPoint.Z) + Query.CapsuleRadius};
+
+		FISAMantleSweep Sweep;
+		Sweep.Start = FVector{Behind.X, Behind.Y, StartZ};
+		Sweep.End = FVector{Behind.X, Behind.Y, StartZ - Settings.MaxLandingDrop};
+		Sweep.Shape = FCollisionShape::MakeSphere(Query.CapsuleRadius);
+
+		return Sweep;
+	}
+
+	void ClassifyLanding(const FISAMantleQuery& Query, const FHitResult& TopHit, const FHitResult& LandingHit, FMantleResult& OutResult)
+	{
+		if (LandingHit.bBlockingHit && !LandingHit.bStartPenetrating)
+		{
+			//Either the floor behind a thin obstacle (vault) or the top of a deep one (climb onto)
+			OutResult.VaultEndPos = LandingHit.ImpactPoint;
+		}
+		else
+		{
+			//Blocked or a bottomless drop behind the obstacle, only climbing onto it is possible
+			OutResult.VaultEndPos = TopHit.ImpactPoint + Query.Forward * Query.CapsuleRadius;
+			OutResult.bCanWarp = !LandingHit.bStartPenetrating;
+		}
+
+		OutResult.bCanMantle = true;
+	}
+
+	void DrawSweep(const UWorld& World, const FISAMantleSweep& Sweep, bool bHit, EDrawDebugTrace::Type DrawDebugType)
+	{
+		if (DrawDebugType == EDrawDebugTrace::None || !IsInGameThread())
+		{
+			return;
+		}
+
+		const bool bPersistent{DrawDebugType == EDrawDebugTrace::Persistent};
+		const float LifeTime{DrawDebugType == EDrawDebugTrace::ForDuration ? 5.f : 0.f};
+		const FColor Color{bHit ? FColor::Green : FColor::Red};
+
+		DrawDebugLine(&World, Sweep.Start, Sweep.End, Color, bPersistent, LifeTime);
+
+		if (Sweep.Shape.IsCapsule())
+		{
+			DrawDebugCapsule(&World, Sweep.End, Sweep.Shape.GetCapsuleHalfHeight(), Sweep.Shape.GetCapsuleRadius(), FQuat::Identity, Color, bPersistent, LifeTime);
+		}
+		else
+		{
+			DrawDebugSphere(&World, Sweep.End, Sweep.Shape.GetSphereRadius(), 8, Color, bPersistent, LifeTime);
+		}
+	}
+
+	bool ValidateMantle(const UWorld& World, const FISAMantleQuery& Query, const FMantleResult& Proposal)
+	{
+		const UMantleSettings& Settings{*Query.Settings};
+		const float Tolerance{Settings.ValidationTolerance};
+
+		//Plausibility, the proposal has to start where the server has the character and stay in reach
+		const FVector ServerStart{Query.Location.X, Query.Location.Y, GetFeetZ(Query)};
+
+		if (!Proposal.bCanMantle || Proposal.MantleType == EISAMantleType::NoMantle
+			|| FVector::DistSquared(Proposal.VaultStartPos, ServerStart) > FMath::Square(Tolerance))
+		{
+			return false;
+		}
+
+		const float MaxReach{Settings.ForwardTraceLength + Settings.MaxVaultDepth + Query.CapsuleRadius + Tolerance};
+
+		if (FVector::DistSquared2D(Proposal.VaultStartPos, Proposal.VaultEndPos) > FMath::Square(MaxReach))
+		{
+			return false;
+		}
+
+		//The mid position sits half a capsule half height below the top of the obstacle
+		const float TopZ{UE_REAL_TO_FLOAT(Proposal.VaultMidPos.Z) + Query.CapsuleHalfHeight / 2};
+		const float Height{TopZ - GetFeetZ(Query)};
+
+		if (Height < Settings.MinMantleHeight - Tolerance || Height > Settings.HighMantleMaxHeight + Tolerance)
+		{
+			return false;
+		}
+
+		const FCollisionShape Sphere{FCollisionShape::MakeSphere(Query.CapsuleRadius)};
+		const float ClearanceZ{TopZ + Query.CapsuleRadius + Settings.TraceRadius};
+
+		//Clearance, nothing may block the way over the obstacle
+		FISAMantleSweep ClearanceSweep;
+		ClearanceSweep.Start = FVector{Proposal.VaultMidPos.X, Proposal.VaultMidPos.Y, ClearanceZ};
+		ClearanceSweep.End = FVector{Proposal.VaultEndPos.X, Proposal.VaultEndPos.Y, ClearanceZ};
+		ClearanceSweep.Shape = Sphere;
+
+		FHitResult ClearanceHit;
+
+		if (RunSweep(World, Query, ClearanceSweep, ClearanceHit))
+		{
+			return false;
+		}
+
+		//Landing, there has to be floor at the proposed end position
+		FISAMantleSweep LandingSweep;
+		LandingSweep.Start = ClearanceSweep.End;
+		LandingSweep.End = Proposal.VaultEndPos - FVector{0, 0, Tolerance};
+		LandingSweep.Shape = Sphere;
+
+		FHitResult LandingHit;
+
+		return RunSweep(World, Query, LandingSweep, LandingHit) && !LandingHit.bStartPenetrating
+			&& FMath::Abs(LandingHit.ImpactPoint.Z - Proposal.VaultEndPos.Z) <= Tolerance;
+	}
+
+	void EvaluateMantle(const UWorld& World, const FISAMantleQuery& Query, FMantleResult& OutResult)
+	{
+		OutResult = {};
+
+		FHitResult ForwardHit;
+
+		if (!RunSweep(World, Query, MakeForwardSweep(Query), ForwardHit))
+		{
+			return;
+		}
+
+		FHitResult TopHit;
+		RunSweep(World, Query, MakeTopSweep(Query, ForwardHit), TopHit);
+
+		if (!ClassifyTop(Query, TopHit, OutResult))
+		{
+			return;
+		}
+
+		FHitResult LandingHit;
+		RunSweep(World, Query, MakeLandingSweep(Query, ForwardHit, TopHit), LandingHit);
+
+		ClassifyLanding(Query, TopHit, LandingHit, OutResult);
+	}
+}
@@ -0,0 +1,133 @@
+#include "Utility/ISAMantleProbe.h"
+
+#include "ISACharacterBase.h"
+#include "Engine/World.h"
+#include "Utility/ISAProfiling.h"
+
+void FISAMantleProbe::Tick(AISACharacterBase& Character)
+{
+	ISA_SCOPED_TIMER(MantleTrace);
+
+	UWorld* World{Character.GetWorld()};
+
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	if (Stage != EStage::Idle)
+	{
+		//Sweep issued last frame, wait until it is back
+		FTraceDatum Datum;
+
+		if (World->QueryTraceData(Handle, Datum))
+		{
+			const FHitResult* BlockingHit{Datum.OutHits.FindByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; })};
+
+			Evaluate(*World, BlockingHit != nullptr ? *BlockingHit : FHitResult{});
+			return;
+		}
+
+		//Results are only kept for the frame after the sweep, a probe that was not ticked then starts over
+		if (GFrameCounter <= IssueFrame + 1)
+		{
+			return;
+		}
+
+		Stage = EStage::Idle;
+		Handle.Invalidate();
+	}
+
+	if (!Character.ShouldProbeMantle())
+	{
+		return;
+	}
+
+	Query = Character.MakeMantleQuery();
+	PendingResult = {};
+	Stage = EStage::Forward;
+
+	Issue(*World, ISAMantle::MakeForwardSweep(Query));
+}
+
+void FISAMantleProbe::Reset()
+{
+	Stage = EStage::Idle;
+	Handle.Invalidate();
+
+	Result = {};
+	ResultFrame = 0;
+}
+
+const FMantleResult* FISAMantleProbe::GetResult(uint64 MaxAgeFrames) const
+{
+	if (ResultFrame == 0 || GFrameCounter - ResultFrame > MaxAgeFrames)
+	{
+		return nullptr;
+	}
+
+	return &Result;
+}
+
+void FISAMantleProbe::Issue(UWorld& World, const FISAMantleSweep& Sweep)
+{
+	PendingSweep = Sweep;
+	IssueFrame = GFrameCounter;
+
+	ISA_INC_PHYSICS_QUERY(Mantle);
+
+	Handle = World.AsyncSweepByObjectType(EAsyncTraceType::Single, Sweep.Start, Sweep.End, FQuat::Identity,
+		ISAMantle::MakeObjectQueryParams(*Query.Settings), Sweep.Shape, ISAMantle::MakeQueryParams(Query));
+}
+
+void FISAMantleProbe::Evaluate(UWorld& World, const FHitResult& Hit)
+{
+	ISAMantle::DrawSweep(World, PendingSweep, Hit.bBlockingHit, Query.Settings->DebugTraceType);
+
+	switch (Stage)
+	{
+	case EStage::Forward:
+		if (!Hit.bBlockingHit)
+		{
+			Resolve();
+			break;
+		}
+
+		ForwardHit = Hit;
+		Stage = EStage::Top;
+
+		Issue(World, ISAMantle::MakeTopSweep(Query, ForwardHit));
+		break;
+
+	case EStage::Top:
+		TopHit = Hit;
+
+		if (!ISAMantle::ClassifyTop(Query, TopHit, PendingResult))
+		{
+			Resolve();
+			break;
+		}
+
+		Stage = EStage::Landing;
+
+		Issue(World, ISAMantle::MakeLandingSweep(Query, ForwardHit, TopHit));
+		break;
+
+	case EStage::Landing:
+		ISAMantle::ClassifyLanding(Query, TopHit, Hit, PendingResult);
+
+		Resolve();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void FISAMantleProbe::Resolve()
+{
+	Result = PendingResult;
+	ResultFrame = GFrameCounter;
+
+	Stage = EStage::Idle;
+}
@@ -0,0 +1,67 @@
+#include "Utility/ISAMantleSubsystem.h"
+
+#include "ISACharacterBase.h"
+#include "Async/ParallelFor.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
+
+void UISAMantleSubsystem::RegisterCharacter(AISACharacterBase* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UISAMantleSubsystem::UnregisterCharacter(AISACharacterBase* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+void UISAMantleSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	LLM_SCOPE_BYTAG(ISA_Scratch);
+
+	ISA_SCOPED_TIMER(MantleTrace);
+
+	//Gather on the game thread, only characters that are walking into something need a result
+	QueryOwners.Reset();
+	Queries.Reset();
+
+	for (AISACharacterBase* Character : Characters)
+	{
+		if (IsValid(Character) && Character->ShouldProbeMantle())
+		{
+			QueryOwners.Add(Character);
+			Queries.Add(Character->MakeMantleQuery());
+		}
+	}
+
+	if (Queries.IsEmpty())
+	{
+		return;
+	}
+
+	Results.SetNum(Queries.Num(), false);
+
+	const UWorld* World{GetWorld()};
+
+	//One read lock for the whole batch instead of one per trace
+	FPhysicsCommand::ExecuteRead(World->GetPhysicsScene(), [this, World]
+	{
+		ParallelFor(Queries.Num(), [this, World](int32 Index)
+		{
+			ISAMantle::EvaluateMantle(*World, Queries[Index], Results[Index]);
+		});
+	});
+
+	for (int i = 0; i < QueryOwners.Num(); i++)
+	{
+		QueryOwners[i]->SetBatchedMantleResult(Results[i]);
+	}
+}
+
+TStatId UISAMantleSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UISAMantleSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,30 @@
+#include "Utility/ISAMemory.h"
+
+LLM_DEFINE_TAG(ISA);
+LLM_DEFINE_TAG(ISA_Character, NAME_None, TEXT("ISA"));
+LLM_DEFINE_TAG(ISA_Animation, NAME_None, TEXT("ISA"));
+LLM_DEFINE_TAG(ISA_Settings, NAME_None, TEXT("ISA"));
+LLM_DEFINE_TAG(ISA_Montages, NAME_None, TEXT("ISA"));
+LLM_DEFINE_TAG(ISA_Interactables, NAME_None, TEXT("ISA"));
+LLM_DEFINE_TAG(ISA_Scratch, NAME_None, TEXT("ISA"));
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+namespace ISAMemory
+{
+	int64 GetTrackedBytes()
+	{
+		//The parent tag holds nothing itself
+		const FName TagNames[]{LLM_TAGNAME(ISA_Character), LLM_TAGNAME(ISA_Animation), LLM_TAGNAME(ISA_Settings), LLM_TAGNAME(ISA_Montages),
+			LLM_TAGNAME(ISA_Interactables), LLM_TAGNAME(ISA_Scratch)};
+
+		int64 Bytes{0};
+
+		for (const FName TagName : TagNames)
+		{
+			Bytes += FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagName, ELLMTagSet::None);
+		}
+
+		return Bytes;
+	}
+}
+#endif
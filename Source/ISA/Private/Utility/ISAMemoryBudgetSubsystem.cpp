@@ -0,0 +1,96 @@
+#include "Utility/ISAMemoryBudgetSubsystem.h"
+
+#include "Algo/Find.h"
+#include "Utility/ISAMemory.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogISAMemory, Log, All);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+namespace
+{
+	//LLM name of a budget tag, none if there is no such ISA tag
+	FName FindTagName(FName Tag)
+	{
+		const TPair<FName, FName> TagNames[]{
+			{TEXT("Character"), LLM_TAGNAME(ISA_Character)},
+			{TEXT("Animation"), LLM_TAGNAME(ISA_Animation)},
+			{TEXT("Settings"), LLM_TAGNAME(ISA_Settings)},
+			{TEXT("Montages"), LLM_TAGNAME(ISA_Montages)},
+			{TEXT("Interactables"), LLM_TAGNAME(ISA_Interactables)},
+			{TEXT("Scratch"), LLM_TAGNAME(ISA_Scratch)}
+		};
+
+		const TPair<FName, FName>* TagName{Algo::FindBy(TagNames, Tag, &TPair<FName, FName>::Key)};
+
+		return TagName != nullptr ? TagName->Value : NAME_None;
+	}
+}
+#endif
+
+bool UISAMemoryBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	return FLowLevelMemTracker::IsEnabled() && Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+void UISAMemoryBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	for (const FISAMemoryBudget& Budget : Budgets)
+	{
+		if (FindTagName(Budget.Tag).IsNone())
+		{
+			UE_LOG(LogISAMemory, Warning, TEXT("There is no ISA LLM tag called %s, its budget is ignored"), *Budget.Tag.ToString());
+		}
+	}
+
+	if (Budgets.IsEmpty())
+	{
+		return;
+	}
+
+	OverBudgets.Init(false, Budgets.Num());
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::CheckBudgets), CheckInterval);
+#endif
+}
+
+void UISAMemoryBudgetSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	Super::Deinitialize();
+}
+
+bool UISAMemoryBudgetSubsystem::CheckBudgets(float DeltaTime)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	for (int32 BudgetIndex = 0; BudgetIndex < Budgets.Num(); BudgetIndex++)
+	{
+		const FISAMemoryBudget& Budget{Budgets[BudgetIndex]};
+		const FName TagName{FindTagName(Budget.Tag)};
+
+		if (TagName.IsNone() || Budget.MaxMegabytes <= 0.f)
+		{
+			continue;
+		}
+
+		const double Megabytes{FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagName, ELLMTagSet::None) / (1024.0 * 1024.0)};
+		const bool bOverBudget{Megabytes > Budget.MaxMegabytes};
+
+		if (bOverBudget && !OverBudgets[BudgetIndex])
+		{
+			UE_LOG(LogISAMemory, Warning, TEXT("ISA/%s is over its budget: %.2f of %.2f MB"), *Budget.Tag.ToString(), Megabytes, Budget.MaxMegabytes);
+		}
+
+		OverBudgets[BudgetIndex] = bOverBudget;
+	}
+#endif
+
+	return true;
+}
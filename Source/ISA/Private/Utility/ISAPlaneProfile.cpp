@@ -0,0 +1,66 @@
+#include "Utility/ISAPlaneProfile.h"
+
+#include "Algo/BinarySearch.h"
+
+float UISAPlaneProfile::ToCoordinate(const FVector& Location) const
+{
+	return UE_REAL_TO_FLOAT(FVector::DotProduct(Location - Origin, Axis));
+}
+
+bool UISAPlaneProfile::IsValidAt(const FVector& Location) const
+{
+	if (Samples.IsEmpty())
+	{
+		return false;
+	}
+
+	//Distance to the vertical plane that contains the axis
+	const FVector Offset{Location - Origin};
+	const FVector OffPlane{(Offset - Axis * FVector::DotProduct(Offset, Axis)) * FVector{1, 1, 0}};
+
+	if (OffPlane.SizeSquared() > FMath::Square(PlaneTolerance))
+	{
+		return false;
+	}
+
+	const float Coordinate{ToCoordinate(Location)};
+
+	return Coordinate >= Samples[0].Coordinate && Coordinate <= Samples.Last().Coordinate;
+}
+
+bool UISAPlaneProfile::FindFloor(const FVector& Location, float MaxDrop, FISAPlaneFloor& OutFloor) const
+{
+	if (!IsValidAt(Location))
+	{
+		return false;
+	}
+
+	//All layers of the closest sample coordinate
+	const float Coordinate{ToCoordinate(Location)};
+	const float HalfSpacing{SampleSpacing / 2};
+
+	int32 Index{Algo::LowerBoundBy(Samples, Coordinate - HalfSpacing, &FISAPlaneProfileSample::Coordinate)};
+
+	const FISAPlaneProfileSample* BestSample{nullptr};
+	const float LocationZ{UE_REAL_TO_FLOAT(Location.Z)};
+
+	for (; Index < Samples.Num() && Samples[Index].Coordinate <= Coordinate + HalfSpacing; Index++)
+	{
+		const FISAPlaneProfileSample& Sample{Samples[Index]};
+
+		if (Sample.FloorZ <= LocationZ && Sample.FloorZ >= LocationZ - MaxDrop && (BestSample == nullptr || Sample.FloorZ > BestSample->FloorZ))
+		{
+			BestSample = &Sample;
+		}
+	}
+
+	if (BestSample == nullptr)
+	{
+		return false;
+	}
+
+	OutFloor.FloorZ = BestSample->FloorZ;
+	OutFloor.Normal = (Axis * (BestSample->NormalAlong / 127.f) + FVector::UpVector * (BestSample->NormalUp / 127.f)).GetSafeNormal();
+
+	return true;
+}
@@ -0,0 +1,24 @@
+#include "Utility/ISAPlaneProfileSubsystem.h"
+
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "Utility/ISAPlaneProfile.h"
+
+FString UISAPlaneProfileSubsystem::GetProfilePackageName(const FString& MapName)
+{
+	return FString::Printf(TEXT("/Game/ISA/PlaneProfiles/%s_PlaneProfile"), *MapName);
+}
+
+void UISAPlaneProfileSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//PIE prefixes the map name, the profile is baked for the original map
+	const FString MapName{UWorld::RemovePIEPrefix(FPackageName::GetShortName(InWorld.GetOutermost()->GetName()))};
+	const FString PackageName{GetProfilePackageName(MapName)};
+
+	if (FPackageName::DoesPackageExist(PackageName))
+	{
+		Profile = LoadObject<UISAPlaneProfile>(nullptr, *FString::Printf(TEXT("%s.%s"), *PackageName, *FPackageName::GetShortName(PackageName)));
+	}
+}
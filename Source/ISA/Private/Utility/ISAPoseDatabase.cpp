@@ -0,0 +1,374 @@
+#include "Utility/ISAPoseDatabase.h"
+
+#include "Algo/StableSort.h"
+#include "Animation/AnimSequence.h"
+#include "Utility/ISAMemory.h"
+#include "Utility/ISAProfiling.h"
+
+namespace
+{
+	static_assert(ISAPoseSearch::FeatureCount == 8, "SquaredDistance compares two vector registers per pose");
+
+	float SquaredDistance(const float* A, const float* B)
+	{
+		const VectorRegister4Float Low{VectorSubtract(VectorLoad(A), VectorLoad(B))};
+		const VectorRegister4Float High{VectorSubtract(VectorLoad(A + 4), VectorLoad(B + 4))};
+
+		float Distance;
+		VectorStoreFloat1(VectorDot4(VectorMultiplyAdd(Low, Low, VectorMultiply(High, High)), GlobalVectorConstants::FloatOne), &Distance);
+
+		return Distance;
+	}
+}
+
+void UISAPoseDatabase::Serialize(FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(ISA_Animation);
+
+	Super::Serialize(Ar);
+}
+
+void UISAPoseDatabase::MakeQuery(const FVector& LocalVelocity, const FVector& LocalAcceleration, float MaxSpeed, float (&OutQuery)[ISAPoseSearch::FeatureCount])
+{
+	OutQuery[0] = UE_REAL_TO_FLOAT(LocalVelocity.X);
+	OutQuery[1] = UE_REAL_TO_FLOAT(LocalVelocity.Y);
+
+	//Integrate with constant acceleration, capped at the max speed
+	const FVector Acceleration{LocalAcceleration.X, LocalAcceleration.Y, 0.f};
+
+	FVector Velocity{LocalVelocity.X, LocalVelocity.Y, 0.f};
+	FVector Position{ForceInit};
+	float PreviousTime{0.f};
+
+	for (int32 i = 0; i < ISAPoseSearch::TrajectorySampleCount; i++)
+	{
+		const float DeltaTime{ISAPoseSearch::TrajectoryTimes[i] - PreviousTime};
+		const FVector NewVelocity{(Velocity + Acceleration * DeltaTime).GetClampedToMaxSize(MaxSpeed)};
+
+		Position += (Velocity + NewVelocity) * 0.5f * DeltaTime;
+		Velocity = NewVelocity;
+		PreviousTime = ISAPoseSearch::TrajectoryTimes[i];
+
+		OutQuery[2 + i * 2] = UE_REAL_TO_FLOAT(Position.X);
+		OutQuery[3 + i * 2] = UE_REAL_TO_FLOAT(Position.Y);
+	}
+}
+
+bool UISAPoseDatabase::Search(const float (&Query)[ISAPoseSearch::FeatureCount], const UAnimSequence* Sequence, float Time, float ContinuingCostBias,
+	FISAPoseSearchResult& OutResult) const
+{
+	ISA_SCOPED_TIMER(PoseSearch);
+
+	if (Sources.IsEmpty() || FeatureScales.Num() != ISAPoseSearch::FeatureCount)
+	{
+		return false;
+	}
+
+	float NormalizedQuery[ISAPoseSearch::FeatureCount];
+
+	for (int32 i = 0; i < ISAPoseSearch::FeatureCount; i++)
+	{
+		NormalizedQuery[i] = Query[i] * FeatureScales[i];
+	}
+
+	//Closest clusters first
+	TArray<TPair<float, int32>, TInlineAllocator<256>> ClusterOrder;
+
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ClusterIndex++)
+	{
+		const float CenterDistance{FMath::Sqrt(SquaredDistance(NormalizedQuery, ClusterCenters.GetData() + ClusterIndex * ISAPoseSearch::FeatureCount))};
+
+		ClusterOrder.Emplace(CenterDistance, ClusterIndex);
+	}
+
+	ClusterOrder.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	int32 BestPose{INDEX_NONE};
+	float BestCost{TNumericLimits<float>::Max()};
+	int32 SearchedPoses{0};
+
+	for (const auto& [CenterDistance, ClusterIndex] : ClusterOrder)
+	{
+		if (SearchedPoses >= MaxPosesPerQuery)
+		{
+			break;
+		}
+
+		const FISAPoseCluster& Cluster{Clusters[ClusterIndex]};
+
+		//No pose in the cluster can be closer than the center distance minus the radius
+		if (BestPose != INDEX_NONE && FMath::Square(FMath::Max(CenterDistance - Cluster.Radius, 0.f)) >= BestCost)
+		{
+			continue;
+		}
+
+		const int32 End{FMath::Min(Cluster.Start + Cluster.Count, Cluster.Start + MaxPosesPerQuery - SearchedPoses)};
+
+		for (int32 PoseIndex = Cluster.Start; PoseIndex < End; PoseIndex++)
+		{
+			const float Cost{ComputeCost(NormalizedQuery, PoseIndex)};
+
+			if (Cost < BestCost)
+			{
+				BestCost = Cost;
+				BestPose = PoseIndex;
+			}
+		}
+
+		SearchedPoses += End - Cluster.Start;
+	}
+
+	ISA_INC_COUNTER_BY(SearchedPoses, SearchedPoses);
+
+	//Keep playing the current clip unless something clearly better was found
+	if (const int32 ContinuingPose{FindPose(Sequence, Time)}; ContinuingPose != INDEX_NONE)
+	{
+		const float ContinuingCost{ComputeCost(NormalizedQuery, ContinuingPose)};
+
+		if (ContinuingCost - ContinuingCostBias <= BestCost)
+		{
+			OutResult.Sequence = Sequences[Sources[ContinuingPose].SequenceIndex];
+			OutResult.Time = Time;
+			OutResult.PoseIndex = ContinuingPose;
+			OutResult.Cost = ContinuingCost;
+
+			return true;
+		}
+	}
+
+	if (BestPose == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutResult.Sequence = Sequences[Sources[BestPose].SequenceIndex];
+	OutResult.Time = Sources[BestPose].Time;
+	OutResult.PoseIndex = BestPose;
+	OutResult.Cost = BestCost;
+
+	return true;
+}
+
+int32 UISAPoseDatabase::FindPose(const UAnimSequence* Sequence, float Time) const
+{
+	const int32 SequenceIndex{Sequence != nullptr ? Sequences.IndexOfByKey(Sequence) : INDEX_NONE};
+
+	if (SequenceIndex == INDEX_NONE || !SequencePoseStarts.IsValidIndex(SequenceIndex + 1))
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Start{SequencePoseStarts[SequenceIndex]};
+	const int32 End{SequencePoseStarts[SequenceIndex + 1]};
+
+	if (Start == End)
+	{
+		return INDEX_NONE;
+	}
+
+	//Samples start at zero and are SampleInterval apart, only the tail of a clip can be missing
+	const int32 Sample{FMath::Clamp(FMath::RoundToInt(Time / SampleInterval), 0, End - Start - 1)};
+
+	return SequencePoses[Start + Sample];
+}
+
+float UISAPoseDatabase::ComputeCost(const float* NormalizedQuery, int32 PoseIndex) const
+{
+	return SquaredDistance(NormalizedQuery, Features.GetData() + PoseIndex * ISAPoseSearch::FeatureCount);
+}
+
+#if WITH_EDITOR
+void UISAPoseDatabase::BuildIndex()
+{
+	constexpr int32 FeatureCount{ISAPoseSearch::FeatureCount};
+
+	//Sample every sequence in sequence and time order
+	TArray<float> RawFeatures;
+	TArray<FISAPoseSource> RawSources;
+
+	SequencePoseStarts.Reset();
+
+	for (int32 SequenceIndex = 0; SequenceIndex < Sequences.Num(); SequenceIndex++)
+	{
+		SequencePoseStarts.Add(RawSources.Num());
+
+		const UAnimSequence* Sequence{Sequences[SequenceIndex]};
+
+		if (!IsValid(Sequence))
+		{
+			continue;
+		}
+
+		const float Length{Sequence->GetPlayLength()};
+		const bool bLooping{Sequence->bLoop};
+		const float Horizon{ISAPoseSearch::TrajectoryTimes[ISAPoseSearch::TrajectorySampleCount - 1]};
+
+		for (int32 Sample = 0;; Sample++)
+		{
+			const float Time{Sample * SampleInterval};
+
+			if (Time >= Length || (!bLooping && Time + Horizon > Length))
+			{
+				break;
+			}
+
+			const FVector Velocity{Sequence->ExtractRootMotion(Time, SampleInterval, bLooping).GetTranslation() / SampleInterval};
+
+			RawFeatures.Add(UE_REAL_TO_FLOAT(Velocity.X));
+			RawFeatures.Add(UE_REAL_TO_FLOAT(Velocity.Y));
+
+			for (const float TrajectoryTime : ISAPoseSearch::TrajectoryTimes)
+			{
+				const FVector Position{Sequence->ExtractRootMotion(Time, TrajectoryTime, bLooping).GetTranslation()};
+
+				RawFeatures.Add(UE_REAL_TO_FLOAT(Position.X));
+				RawFeatures.Add(UE_REAL_TO_FLOAT(Position.Y));
+			}
+
+			RawSources.Add({SequenceIndex, Time});
+		}
+	}
+
+	SequencePoseStarts.Add(RawSources.Num());
+
+	const int32 PoseCount{RawSources.Num()};
+
+	//Every feature pair (velocity, each trajectory point) is scaled by its deviation, so the weights are comparable
+	FeatureScales.Init(1.f, FeatureCount);
+
+	if (PoseCount > 0)
+	{
+		for (int32 Pair = 0; Pair < FeatureCount / 2; Pair++)
+		{
+			double Mean[2]{0.0, 0.0};
+			double SquaredMean[2]{0.0, 0.0};
+
+			for (int32 PoseIndex = 0; PoseIndex < PoseCount; PoseIndex++)
+			{
+				for (int32 Axis = 0; Axis < 2; Axis++)
+				{
+					const double Value{RawFeatures[PoseIndex * FeatureCount + Pair * 2 + Axis]};
+					Mean[Axis] += Value / PoseCount;
+					SquaredMean[Axis] += Value * Value / PoseCount;
+				}
+			}
+
+			const double Variance{(SquaredMean[0] - Mean[0] * Mean[0] + SquaredMean[1] - Mean[1] * Mean[1]) / 2};
+			const float Deviation{FMath::Max(UE_REAL_TO_FLOAT(FMath::Sqrt(FMath::Max(Variance, 0.0))), UE_KINDA_SMALL_NUMBER)};
+			const float Scale{(Pair == 0 ? VelocityWeight : TrajectoryWeight) / Deviation};
+
+			FeatureScales[Pair * 2] = Scale;
+			FeatureScales[Pair * 2 + 1] = Scale;
+		}
+	}
+
+	for (int32 i = 0; i < RawFeatures.Num(); i++)
+	{
+		RawFeatures[i] *= FeatureScales[i % FeatureCount];
+	}
+
+	//K-means, seeded with evenly spaced poses so a rebuild gives the same index
+	const int32 Count{FMath::Min(ClusterCount, PoseCount)};
+
+	ClusterCenters.SetNumZeroed(Count * FeatureCount);
+
+	for (int32 ClusterIndex = 0; ClusterIndex < Count; ClusterIndex++)
+	{
+		FMemory::Memcpy(&ClusterCenters[ClusterIndex * FeatureCount], &RawFeatures[ClusterIndex * PoseCount / Count * FeatureCount], FeatureCount * sizeof(float));
+	}
+
+	TArray<int32> Assignments;
+	Assignments.SetNumZeroed(PoseCount);
+
+	auto Assign{[&]
+	{
+		for (int32 PoseIndex = 0; PoseIndex < PoseCount; PoseIndex++)
+		{
+			float BestDistance{TNumericLimits<float>::Max()};
+
+			for (int32 ClusterIndex = 0; ClusterIndex < Count; ClusterIndex++)
+			{
+				const float Distance{SquaredDistance(&RawFeatures[PoseIndex * FeatureCount], &ClusterCenters[ClusterIndex * FeatureCount])};
+
+				if (Distance < BestDistance)
+				{
+					BestDistance = Distance;
+					Assignments[PoseIndex] = ClusterIndex;
+				}
+			}
+		}
+	}};
+
+	for (int32 Iteration = 0; Iteration < ClusterIterations; Iteration++)
+	{
+		Assign();
+
+		TArray<float> Sums;
+		Sums.SetNumZeroed(Count * FeatureCount);
+
+		TArray<int32> Members;
+		Members.SetNumZeroed(Count);
+
+		for (int32 PoseIndex = 0; PoseIndex < PoseCount; PoseIndex++)
+		{
+			Members[Assignments[PoseIndex]]++;
+
+			for (int32 i = 0; i < FeatureCount; i++)
+			{
+				Sums[Assignments[PoseIndex] * FeatureCount + i] += RawFeatures[PoseIndex * FeatureCount + i];
+			}
+		}
+
+		//Empty clusters keep their old center
+		for (int32 ClusterIndex = 0; ClusterIndex < Count; ClusterIndex++)
+		{
+			for (int32 i = 0; Members[ClusterIndex] > 0 && i < FeatureCount; i++)
+			{
+				ClusterCenters[ClusterIndex * FeatureCount + i] = Sums[ClusterIndex * FeatureCount + i] / Members[ClusterIndex];
+			}
+		}
+	}
+
+	Assign();
+
+	//Store the poses grouped by cluster
+	TArray<int32> Order;
+	Order.SetNumUninitialized(PoseCount);
+
+	for (int32 PoseIndex = 0; PoseIndex < PoseCount; PoseIndex++)
+	{
+		Order[PoseIndex] = PoseIndex;
+	}
+
+	Algo::StableSortBy(Order, [&Assignments](int32 PoseIndex) { return Assignments[PoseIndex]; });
+
+	Features.SetNumUninitialized(PoseCount * FeatureCount);
+	Sources.SetNum(PoseCount);
+	SequencePoses.SetNum(PoseCount);
+
+	Clusters.Reset();
+	Clusters.SetNum(Count);
+
+	for (int32 PoseIndex = 0; PoseIndex < PoseCount; PoseIndex++)
+	{
+		const int32 RawIndex{Order[PoseIndex]};
+		const int32 ClusterIndex{Assignments[RawIndex]};
+
+		FMemory::Memcpy(&Features[PoseIndex * FeatureCount], &RawFeatures[RawIndex * FeatureCount], FeatureCount * sizeof(float));
+		Sources[PoseIndex] = RawSources[RawIndex];
+		SequencePoses[RawIndex] = PoseIndex;
+
+		FISAPoseCluster& Cluster{Clusters[ClusterIndex]};
+
+		if (Cluster.Count == 0)
+		{
+			Cluster.Start = PoseIndex;
+		}
+
+		Cluster.Count++;
+		Cluster.Radius = FMath::Max(Cluster.Radius, FMath::Sqrt(SquaredDistance(&Features[PoseIndex * FeatureCount], &ClusterCenters[ClusterIndex * FeatureCount])));
+	}
+
+	MarkPackageDirty();
+}
+#endif
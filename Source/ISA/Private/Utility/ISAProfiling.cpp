@@ -0,0 +1,75 @@
+#include "Utility/ISAProfiling.h"
+
+DEFINE_STAT(STAT_ISA_PhysSlide);
+DEFINE_STAT(STAT_ISA_CanSlide);
+DEFINE_STAT(STAT_ISA_RefreshGait);
+DEFINE_STAT(STAT_ISA_MantleTrace);
+DEFINE_STAT(STAT_ISA_PushTick);
+DEFINE_STAT(STAT_ISA_Interact);
+DEFINE_STAT(STAT_ISA_AnimUpdate);
+DEFINE_STAT(STAT_ISA_AnimThreadSafeUpdate);
+DEFINE_STAT(STAT_ISA_PoseSearch);
+
+DEFINE_STAT(STAT_ISA_PhysicsQueries);
+DEFINE_STAT(STAT_ISA_SlideQueries);
+DEFINE_STAT(STAT_ISA_MantleQueries);
+DEFINE_STAT(STAT_ISA_InteractQueries);
+DEFINE_STAT(STAT_ISA_PushQueries);
+DEFINE_STAT(STAT_ISA_MovementUpdates);
+DEFINE_STAT(STAT_ISA_SlideIterations);
+DEFINE_STAT(STAT_ISA_MantleProbes);
+DEFINE_STAT(STAT_ISA_InteractableCandidates);
+DEFINE_STAT(STAT_ISA_SearchedPoses);
+
+CSV_DEFINE_CATEGORY_MODULE(ISA_API, ISA, true);
+
+namespace ISAProfiling
+{
+	const TCHAR* ToString(ETimer Timer)
+	{
+		static const TCHAR* Names[]{TEXT("PhysSlide"), TEXT("CanSlide"), TEXT("RefreshGait"), TEXT("MantleTrace"), TEXT("PushTick"), TEXT("Interact"),
+			TEXT("AnimUpdate"), TEXT("AnimThreadSafeUpdate"), TEXT("PoseSearch")};
+		static_assert(UE_ARRAY_COUNT(Names) == TimerCount);
+
+		return Names[static_cast<int32>(Timer)];
+	}
+
+	const TCHAR* ToString(ECounter Counter)
+	{
+		static const TCHAR* Names[]{TEXT("PhysicsQueries"), TEXT("SlideQueries"), TEXT("MantleQueries"), TEXT("InteractQueries"), TEXT("PushQueries"),
+			TEXT("MovementUpdates"), TEXT("SlideIterations"), TEXT("MantleProbes"), TEXT("InteractableCandidates"), TEXT("SearchedPoses")};
+		static_assert(UE_ARRAY_COUNT(Names) == CounterCount);
+
+		return Names[static_cast<int32>(Counter)];
+	}
+
+#if ISA_WITH_PROFILING
+	std::atomic<bool> bEnabled{false};
+
+	std::atomic<uint64> TimerCycles[TimerCount]{};
+	std::atomic<uint64> CounterValues[CounterCount]{};
+
+	void Reset()
+	{
+		for (std::atomic<uint64>& Cycles : TimerCycles)
+		{
+			Cycles.store(0, std::memory_order_relaxed);
+		}
+
+		for (std::atomic<uint64>& Value : CounterValues)
+		{
+			Value.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	double GetTimerSeconds(ETimer Timer)
+	{
+		return FPlatformTime::ToSeconds64(TimerCycles[static_cast<int32>(Timer)].load(std::memory_order_relaxed));
+	}
+
+	uint64 GetCounter(ECounter Counter)
+	{
+		return CounterValues[static_cast<int32>(Counter)].load(std::memory_order_relaxed);
+	}
+#endif
+}
@@ -1 +1,94 @@
 #include "Utility/ISASettings.h"
+
+#include "Utility/ISAMemory.h"
+
+FISASignificanceSettings::FISASignificanceSettings()
+{
+	//Foreground, midground and background
+	FISASignificanceTier& Foreground{Tiers.AddDefaulted_GetRef()};
+	Foreground.MaxDistance = 2000.f;
+
+	FISASignificanceTier& Midground{Tiers.AddDefaulted_GetRef()};
+	Midground.MaxDistance = 5000.f;
+	Midground.MovementTickInterval = 1.f / 30.f;
+	Midground.MaxSimulationIterations = 4;
+	Midground.AnimationTickInterval = 1.f / 30.f;
+	Midground.bTickPoseWhenNotRendered = false;
+	Midground.ComponentTickInterval = 0.1f;
+	Midground.bProbeMantle = false;
+
+	FISASignificanceTier& Background{Tiers.AddDefaulted_GetRef()};
+	Background.MovementTickInterval = 0.1f;
+	Background.MaxSimulationIterations = 1;
+	Background.AnimationTickInterval = 0.25f;
+	Background.bTickPoseWhenNotRendered = false;
+	Background.ComponentTickInterval = 0.5f;
+	Background.bProbeMantle = false;
+}
+
+int32 FISASignificanceSettings::SelectTier(float Distance, int32 CurrentTier) const
+{
+	if (Tiers.IsEmpty())
+	{
+		return 0;
+	}
+
+	int32 Tier{FMath::Clamp(CurrentTier, 0, Tiers.Num() - 1)};
+
+	while (Tier > 0 && Distance < Tiers[Tier - 1].MaxDistance - HysteresisDistance)
+	{
+		Tier--;
+	}
+
+	while (Tier < Tiers.Num() - 1 && Distance > Tiers[Tier].MaxDistance + HysteresisDistance)
+	{
+		Tier++;
+	}
+
+	return Tier;
+}
+
+void UISASettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BakeSpeedTable();
+}
+
+void UISASettings::Serialize(FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(ISA_Settings);
+
+	Super::Serialize(Ar);
+}
+
+void UISASettings::PostLoad()
+{
+	Super::PostLoad();
+
+	BakeSpeedTable();
+}
+
+#if WITH_EDITOR
+void UISASettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BakeSpeedTable();
+}
+#endif
+
+void UISASettings::BakeSpeedTable()
+{
+	auto& Standing{SpeedTable[static_cast<uint8>(EISAStance::Standing)]};
+
+	Standing[static_cast<uint8>(EISAGait::Walking)] = WalkSpeed;
+	Standing[static_cast<uint8>(EISAGait::Running)] = RunSpeed;
+	Standing[static_cast<uint8>(EISAGait::Sprinting)] = SprintSpeed;
+
+	//Crouching has a single speed for every gait
+	for (float& CrouchingSpeed : SpeedTable[static_cast<uint8>(EISAStance::Crouching)])
+	{
+		CrouchingSpeed = CrouchSpeed;
+	}
+}
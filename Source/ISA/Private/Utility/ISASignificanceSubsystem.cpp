@@ -0,0 +1,90 @@
+#include "Utility/ISASignificanceSubsystem.h"
+
+#include "ISACharacterBase.h"
+#include "SignificanceManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Utility/ISAMemory.h"
+
+const FName UISASignificanceSubsystem::SignificanceTag{TEXT("ISACharacter")};
+
+void UISASignificanceSubsystem::RegisterCharacter(AISACharacterBase* Character)
+{
+	auto* SignificanceManager{USignificanceManager::Get(GetWorld())};
+
+	if (SignificanceManager == nullptr)
+	{
+		return;
+	}
+
+	//Significance is the negative distance, so the closest viewpoint wins. Runs in parallel, only reads the location
+	auto SignificanceFunction{[](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint)
+	{
+		const auto* ManagedCharacter{static_cast<const AISACharacterBase*>(ObjectInfo->GetObject())};
+
+		return -UE_REAL_TO_FLOAT(FVector::Dist(ManagedCharacter->GetActorLocation(), Viewpoint.GetLocation()));
+	}};
+
+	//Sequential, so the character can change its tick settings on the game thread
+	auto PostSignificanceFunction{[](USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal)
+	{
+		if (!bFinal)
+		{
+			static_cast<AISACharacterBase*>(ObjectInfo->GetObject())->UpdateSignificance(-Significance);
+		}
+	}};
+
+	SignificanceManager->RegisterObject(Character, SignificanceTag, SignificanceFunction,
+		USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+void UISASignificanceSubsystem::UnregisterCharacter(AISACharacterBase* Character)
+{
+	if (auto* SignificanceManager{USignificanceManager::Get(GetWorld())})
+	{
+		SignificanceManager->UnregisterObject(Character);
+	}
+}
+
+void UISASignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	LLM_SCOPE_BYTAG(ISA_Scratch);
+
+	auto* SignificanceManager{USignificanceManager::Get(GetWorld())};
+
+	if (SignificanceManager == nullptr)
+	{
+		return;
+	}
+
+	Viewpoints.Reset();
+
+	for (auto Iterator{GetWorld()->GetPlayerControllerIterator()}; Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController{Iterator->Get()};
+
+		//Remote players count too, a server simulates everything close to any of them
+		if (IsValid(PlayerController))
+		{
+			FVector Location;
+			FRotator Rotation;
+			PlayerController->GetPlayerViewPoint(Location, Rotation);
+
+			Viewpoints.Emplace(Rotation, Location);
+		}
+	}
+
+	//Without a viewpoint everything would fall to the last tier, keep the current tiers instead
+	if (Viewpoints.IsEmpty())
+	{
+		return;
+	}
+
+	SignificanceManager->Update(Viewpoints);
+}
+
+TStatId UISASignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UISASignificanceSubsystem, STATGROUP_Tickables);
+}
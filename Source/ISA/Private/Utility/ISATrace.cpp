@@ -0,0 +1,149 @@
+#include "Utility/ISATrace.h"
+
+#if ISA_TRACE_ENABLED
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Utility/MantleSettings.h"
+
+UE_TRACE_CHANNEL_DEFINE(ISAChannel)
+
+//Which part of the locomotion state changed, the values are the ISA enums
+UE_TRACE_EVENT_BEGIN(ISA, LocomotionTransition)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(double, RecordingTime)
+	UE_TRACE_EVENT_FIELD(uint64, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, Kind)
+	UE_TRACE_EVENT_FIELD(uint8, PreviousValue)
+	UE_TRACE_EVENT_FIELD(uint8, NewValue)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ISA, Slide)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(double, RecordingTime)
+	UE_TRACE_EVENT_FIELD(uint64, ActorId)
+	UE_TRACE_EVENT_FIELD(float, Speed)
+	UE_TRACE_EVENT_FIELD(bool, bEntered)
+	UE_TRACE_EVENT_FIELD(uint8, ExitReason)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ISA, MantleResult)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(double, RecordingTime)
+	UE_TRACE_EVENT_FIELD(uint64, ActorId)
+	UE_TRACE_EVENT_FIELD(bool, bCanMantle)
+	UE_TRACE_EVENT_FIELD(bool, bCanWarp)
+	UE_TRACE_EVENT_FIELD(bool, bProbed)
+	UE_TRACE_EVENT_FIELD(uint8, MantleType)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ISA, Push)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(double, RecordingTime)
+	UE_TRACE_EVENT_FIELD(uint64, ActorId)
+	UE_TRACE_EVENT_FIELD(uint64, PushableId)
+	UE_TRACE_EVENT_FIELD(bool, bBegin)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+	enum class ETransitionKind : uint8
+	{
+		LocomotionMode,
+		Stance,
+		Gait,
+		LocomotionAction
+	};
+
+	//Makes sure the actor itself is in the trace so its events can be matched to it
+	uint64 GetActorId(const AActor& Actor)
+	{
+		TRACE_OBJECT(&Actor);
+
+		return FObjectTrace::GetObjectId(&Actor);
+	}
+
+	double GetRecordingTime(const AActor& Actor)
+	{
+		return FObjectTrace::GetWorldElapsedTime(Actor.GetWorld());
+	}
+
+	void OutputTransition(const AActor& Actor, ETransitionKind Kind, uint8 PreviousValue, uint8 NewValue)
+	{
+		UE_TRACE_LOG(ISA, LocomotionTransition, ISAChannel)
+			<< LocomotionTransition.Cycle(FPlatformTime::Cycles64())
+			<< LocomotionTransition.RecordingTime(GetRecordingTime(Actor))
+			<< LocomotionTransition.ActorId(GetActorId(Actor))
+			<< LocomotionTransition.Kind(static_cast<uint8>(Kind))
+			<< LocomotionTransition.PreviousValue(PreviousValue)
+			<< LocomotionTransition.NewValue(NewValue);
+	}
+
+	void OutputSlide(const AActor& Actor, bool bEntered, EISASlideExitReason ExitReason, float Speed)
+	{
+		UE_TRACE_LOG(ISA, Slide, ISAChannel)
+			<< Slide.Cycle(FPlatformTime::Cycles64())
+			<< Slide.RecordingTime(GetRecordingTime(Actor))
+			<< Slide.ActorId(GetActorId(Actor))
+			<< Slide.Speed(Speed)
+			<< Slide.bEntered(bEntered)
+			<< Slide.ExitReason(static_cast<uint8>(ExitReason));
+	}
+}
+
+namespace ISATrace
+{
+	void OutputLocomotionTransition(const AActor& Actor, EISALocomotionMode PreviousLocomotionMode, EISALocomotionMode NewLocomotionMode)
+	{
+		OutputTransition(Actor, ETransitionKind::LocomotionMode, static_cast<uint8>(PreviousLocomotionMode), static_cast<uint8>(NewLocomotionMode));
+	}
+
+	void OutputLocomotionTransition(const AActor& Actor, EISAStance PreviousStance, EISAStance NewStance)
+	{
+		OutputTransition(Actor, ETransitionKind::Stance, static_cast<uint8>(PreviousStance), static_cast<uint8>(NewStance));
+	}
+
+	void OutputLocomotionTransition(const AActor& Actor, EISAGait PreviousGait, EISAGait NewGait)
+	{
+		OutputTransition(Actor, ETransitionKind::Gait, static_cast<uint8>(PreviousGait), static_cast<uint8>(NewGait));
+	}
+
+	void OutputLocomotionTransition(const AActor& Actor, EISALocomotionAction PreviousLocomotionAction, EISALocomotionAction NewLocomotionAction)
+	{
+		OutputTransition(Actor, ETransitionKind::LocomotionAction, static_cast<uint8>(PreviousLocomotionAction), static_cast<uint8>(NewLocomotionAction));
+	}
+
+	void OutputSlideEnter(const AActor& Actor, float Speed)
+	{
+		OutputSlide(Actor, true, {}, Speed);
+	}
+
+	void OutputSlideExit(const AActor& Actor, EISASlideExitReason Reason, float Speed)
+	{
+		OutputSlide(Actor, false, Reason, Speed);
+	}
+
+	void OutputMantleResult(const AActor& Actor, const FMantleResult& Result, bool bProbed)
+	{
+		UE_TRACE_LOG(ISA, MantleResult, ISAChannel)
+			<< MantleResult.Cycle(FPlatformTime::Cycles64())
+			<< MantleResult.RecordingTime(GetRecordingTime(Actor))
+			<< MantleResult.ActorId(GetActorId(Actor))
+			<< MantleResult.bCanMantle(Result.bCanMantle)
+			<< MantleResult.bCanWarp(Result.bCanWarp)
+			<< MantleResult.bProbed(bProbed)
+			<< MantleResult.MantleType(static_cast<uint8>(Result.MantleType));
+	}
+
+	void OutputPush(const AActor& Actor, const AActor* Pushable, bool bBegin)
+	{
+		UE_TRACE_LOG(ISA, Push, ISAChannel)
+			<< Push.Cycle(FPlatformTime::Cycles64())
+			<< Push.RecordingTime(GetRecordingTime(Actor))
+			<< Push.ActorId(GetActorId(Actor))
+			<< Push.PushableId(Pushable != nullptr ? GetActorId(*Pushable) : 0)
+			<< Push.bBegin(bBegin);
+	}
+}
+
+#endif
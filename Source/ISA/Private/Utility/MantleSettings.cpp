@@ -2,3 +2,12 @@
 
 
 #include "Utility/MantleSettings.h"
+
+#include "Utility/ISAMemory.h"
+
+void UMantleSettings::Serialize(FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(ISA_Settings);
+
+	Super::Serialize(Ar);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ISABakePlaneProfileCommandlet.generated.h"
+
+class UISAPlaneProfile;
+struct FISAPlaneProfileSample;
+
+//Bakes the 2.5D plane profile of the static geometry of a level, traced with the same collision profile as the runtime fallback.
+//The plane goes through -PlaneOrigin, or the first player start of the level, moved sideways by -PlaneOffset.
+//Usage: -run=ISABakePlaneProfile -Map=/Game/ThirdPerson/Maps/ThirdPersonMap [-Axis=X|Y] [-PlaneOrigin=(X=0,Y=0,Z=0)] [-PlaneOffset=0]
+//       [-Spacing=10] [-Tolerance=50]
+UCLASS()
+class ISA_API UISABakePlaneProfileCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UISABakePlaneProfileCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	//Floor layers per column, top to bottom
+	static constexpr int32 MaxLayers{4};
+
+	static void BakeColumns(const UWorld& World, UISAPlaneProfile& Profile, float Length, float TopZ, float BottomZ,
+		TArray<TArray<FISAPlaneProfileSample>>& OutColumns);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ISABenchmarkCommandlet.generated.h"
+
+class AISAPlayerCharacter;
+class AISAPushableBase;
+class FISABenchmarkWorld;
+
+//Runs N characters through scripted locomotion in a generated world and writes the time of every ISA hot path as JSON.
+//-CompareTiers runs them again on the last significance tier and fails when that costs more than a tenth of the first tier.
+//Usage: -run=ISABenchmark -nullrhi [-Characters=100] [-Frames=600] [-WarmupFrames=60] [-FrameRate=60] [-CompareTiers]
+//       [-CharacterClass=/Game/ThirdPerson/Blueprints/BP_PlayerCharacter.BP_PlayerCharacter_C] [-Output=<json file>]
+UCLASS()
+class ISA_API UISABenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UISABenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	//One character with its own lane: run up, mantle obstacle, slide slope and a crate beside the path
+	struct FLane
+	{
+		AISAPlayerCharacter* Character{nullptr};
+
+		AISAPushableBase* Crate{nullptr};
+
+		FVector Origin{ForceInit};
+
+		int32 Lap{0};
+
+		float PushTime{0.f};
+
+		bool bPushedThisLap{false};
+	};
+
+	static void BuildLane(const FISABenchmarkWorld& Builder, FLane& Lane);
+
+	//Feeds the same input the player input handlers get, gait changes every lap
+	static void DriveLane(FLane& Lane, float DeltaTime);
+
+	static void ResetLane(FLane& Lane);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AISADoorBase;
+class AISAPlayerCharacter;
+class AISAPushableBase;
+class AStaticMeshActor;
+class UPackage;
+class UStaticMesh;
+class UWorld;
+
+//Builds benchmark worlds out of the engine basic shapes, shared by the ISA commandlets
+class ISA_API FISABenchmarkWorld
+{
+public:
+	//Creates an initialized game world with its own world context
+	static UWorld* Create(FName Name);
+
+	//Creates an editor world to be saved as the map in Package
+	static UWorld* CreateForPackage(UPackage& Package, FName Name);
+
+	//Starts play without a game mode, actors spawned afterwards begin play right away
+	static void BeginPlay(UWorld& World);
+
+	static void Destroy(UWorld* World);
+
+	//Advances the world by one frame the way the engine loop does
+	static void Tick(UWorld& World, float DeltaTime);
+
+	static constexpr const TCHAR* DefaultCharacterClass{TEXT("/Game/ThirdPerson/Blueprints/BP_PlayerCharacter.BP_PlayerCharacter_C")};
+
+public:
+	explicit FISABenchmarkWorld(UWorld& InWorld);
+
+	//Box standing on Location
+	AStaticMeshActor* AddBox(const FVector& Location, const FVector& Size, const FRotator& Rotation = FRotator::ZeroRotator) const;
+
+	//Ramp whose top edge is at Location, going down along Direction
+	AStaticMeshActor* AddSlope(const FVector& Location, const FVector& Direction, float Length, float Width, float Angle) const;
+
+	//Any mesh scaled so its bounds fill Size, standing on Location
+	AStaticMeshActor* AddMesh(UStaticMesh& Mesh, const FVector& Location, const FVector& Size, const FRotator& Rotation = FRotator::ZeroRotator) const;
+
+	//Cube crate standing on Location with a push transform on each side
+	AISAPushableBase* AddCrate(const FVector& Location, float Size) const;
+
+	//Door standing on Location, interacting warps the character by WarpOffset in world space
+	AISADoorBase* AddDoor(const FVector& Location, float Yaw, const FVector& WarpOffset) const;
+
+	//Possessed by an AI controller and animated while nothing is rendered, standing on Location
+	AISAPlayerCharacter* AddCharacter(UClass& CharacterClass, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator) const;
+
+private:
+	AStaticMeshActor* AddCube(const FVector& Center, const FVector& Size, const FRotator& Rotation) const;
+
+private:
+	UWorld& World;
+
+	//Engine cube, 100 cm and centered on its pivot
+	UStaticMesh* CubeMesh;
+
+	static constexpr float CubeSize{100.f};
+
+	static constexpr float SlopeThickness{20.f};
+
+	//Gap between a crate and the capsule of a character pushing it
+	static constexpr float PushDistance{60.f};
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ISAGenerateLevelCommandlet.generated.h"
+
+class FISABenchmarkWorld;
+struct FRandomStream;
+
+//Generates a stress level for the ISA code paths out of mantle ledges, slide slopes, pushable crates and warp doors, the same seed gives the same level.
+//Usage: -run=ISAGenerateLevel -Map=/Game/Benchmarks/ISAStress [-Seed=0] [-Ledges=1000] [-Slopes=200] [-Crates=200] [-Doors=100]
+//       [-MinLedgeHeight=50] [-MaxLedgeHeight=250] [-MinSlopeAngle=10] [-MaxSlopeAngle=35]
+UCLASS()
+class ISA_API UISAGenerateLevelCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UISAGenerateLevelCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	enum class EFeature : uint8
+	{
+		Ledge,
+		Slope,
+		Crate,
+		Door
+	};
+
+	struct FFeatureRanges
+	{
+		FFloatRange LedgeHeight{50.f, 250.f};
+
+		FFloatRange SlopeAngle{10.f, 35.f};
+	};
+
+	//Every feature gets its own cell of the grid, turned to a random side around the cell center
+	static constexpr float CellSize{1200.f};
+
+	static void AddFeature(const FISABenchmarkWorld& Builder, FRandomStream& Stream, const FFeatureRanges& Ranges, EFeature Feature, const FVector& Center);
+};
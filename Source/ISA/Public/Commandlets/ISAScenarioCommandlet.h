@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ISAScenarioCommandlet.generated.h"
+
+//Runs fixed locomotion scenarios headless, checks that each one reaches its goal and compares the physics queries and counters of the
+//ISA code paths, the frame time and the memory the ISA code paths retain against the baseline in Benchmarks/ISAScenarioBaseline.json.
+//The baseline is recorded on the reference machine with -llm -WriteBaseline, and comparing against it needs -llm as well.
+//The times of the single code paths are reported but not compared. Returns 1 when a scenario fails or a metric is over its tolerance.
+//Usage: -run=ISAScenario -nullrhi -llm [-Scenario=<name>] [-Baseline=<json file>] [-WriteBaseline]
+//       [-CharacterClass=/Game/ThirdPerson/Blueprints/BP_PlayerCharacter.BP_PlayerCharacter_C]
+UCLASS()
+class ISA_API UISAScenarioCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UISAScenarioCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
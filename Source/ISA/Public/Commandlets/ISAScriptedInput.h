@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AISAPlayerCharacter;
+
+//Makes the same calls as the input bindings of a player character, used by the ISA commandlets to drive characters headless
+class ISA_API FISAScriptedInput
+{
+public:
+	//Forward and right in control space
+	static void Move(AISAPlayerCharacter& Character, const FVector2D& Direction);
+
+	//Pressing starts a mantle when there is an obstacle in front
+	static void Jump(AISAPlayerCharacter& Character, bool bPressed);
+
+	//Starts a push or a door interaction, ends the push while pushing
+	static void Interact(AISAPlayerCharacter& Character);
+
+	static bool IsPushing(const AISAPlayerCharacter& Character);
+
+	static void EndPush(AISAPlayerCharacter& Character);
+};
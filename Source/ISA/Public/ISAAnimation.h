@@ -4,11 +4,28 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
-#include "Utility/ISAGameplayTags.h"
+#include "Utility/ISALocomotionState.h"
 
 #include "ISAAnimation.generated.h"
 
 class AISACharacterBase;
+class UAnimSequence;
+class UISAPoseDatabase;
+struct FStreamableHandle;
+
+//A linked anim layer class that is only loaded once a character needs it
+USTRUCT(BlueprintType)
+struct ISA_API FISALinkedLayer
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Linked Layers")
+	TSoftClassPtr<UAnimInstance> LayerClass;
+
+	//Starts loading when the character begins play instead of on the first change to this stance or action
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Linked Layers")
+	bool bPreload{false};
+};
 
 UCLASS()
 class ISA_API UISAAnimation : public UAnimInstance
@@ -20,7 +37,7 @@ protected:
 	TObjectPtr<AISACharacterBase> ISACharacter;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
-FGameplayTag LocomotionMode{ISALocomotionModeTags::Grounded};
+	FGameplayTag LocomotionMode{ISALocomotionModeTags::Grounded};
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
 	FGameplayTag Stance{ISAStanceTags::Standing};
@@ -31,11 +48,101 @@ FGameplayTag LocomotionMode{ISALocomotionModeTags::Grounded};
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
 	FGameplayTag LocomotionAction;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient, Meta = (ForceUnits = "cm/s"))
+	float Speed{0.f};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
+	bool bHasInput{false};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
+	bool bIsMoving{false};
+
+	//Optional motion matching backend, when set the blueprint plays MotionMatchedSequence at MotionMatchedTime
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Motion Matching")
+	TObjectPtr<UISAPoseDatabase> PoseDatabase;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Motion Matching", Meta = (ClampMin = 0, ForceUnits = "s"))
+	float SearchInterval{0.1f};
+
+	//How much worse than the best pose the playing pose may be before the search jumps
+	UPROPERTY(EditDefaultsOnly, Category = "Motion Matching", Meta = (ClampMin = 0))
+	float ContinuingCostBias{0.5f};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Motion Matching", Transient)
+	TObjectPtr<UAnimSequence> MotionMatchedSequence;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Motion Matching", Transient, Meta = (ForceUnits = "s"))
+	float MotionMatchedTime{0.f};
+
+	//Linked while the character is in the stance, stances without an entry use the layers implemented by this class
+	UPROPERTY(EditDefaultsOnly, Category = "Linked Layers", Meta = (Categories = "ISA.Stance", ForceInlineRow))
+	TMap<FGameplayTag, FISALinkedLayer> StanceLayers;
+
+	//Linked on top of the stance layer while the action runs
+	UPROPERTY(EditDefaultsOnly, Category = "Linked Layers", Meta = (Categories = "ISA.LocomotionAction", ForceInlineRow))
+	TMap<FGameplayTag, FISALinkedLayer> LocomotionActionLayers;
+
+private:
+	UPROPERTY(Transient)
+	TSubclassOf<UAnimInstance> LinkedStanceLayer;
+
+	UPROPERTY(Transient)
+	TSubclassOf<UAnimInstance> LinkedLocomotionActionLayer;
+
+	//Keeps every requested layer class loaded for the lifetime of the anim instance
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> LayerLoadHandles;
+
+private:
+	//Copied from the character on the game thread, everything above is derived from it on a worker thread
+	struct FSnapshot
+	{
+		FISALocomotionState LocomotionState;
+
+		//Set when LocomotionState was copied this frame, the tags are only converted then
+		bool bLocomotionStateChanged{true};
+
+		float Speed{0.f};
+
+		bool bHasInput{false};
+
+		//Mesh space, the space the clips' root motion is in, only gathered for motion matching
+		FVector LocalVelocity{ForceInit};
+
+		FVector LocalAcceleration{ForceInit};
+
+		float MaxSpeed{0.f};
+	};
+
+	FSnapshot Snapshot;
+
+	float TimeSinceSearch{0.f};
+
+	void UpdateMotionMatching(float DeltaTime);
+
+	//Raised by the character change events on the game thread
+	bool bLocomotionStateDirty{true};
+
+	void MarkLocomotionStateDirty();
+
+	void OnStanceChanged(AISACharacterBase& Character, EISAStance PreviousStance, EISAStance NewStance);
+
+	void OnLocomotionActionChanged(AISACharacterBase& Character, EISALocomotionAction PreviousLocomotionAction, EISALocomotionAction NewLocomotionAction);
+
+	//Starts loading the layer class, the layers are refreshed once it is loaded
+	void RequestLinkedLayer(const FISALinkedLayer* Layer);
+
+	//Links the loaded layers for the current stance and locomotion action
+	void RefreshLinkedLayers();
+
 public:
 	virtual void NativeInitializeAnimation() override;
 
 	virtual void NativeBeginPlay() override;
 
+	virtual void NativeUninitializeAnimation() override;
+
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
 	
 };
@@ -6,12 +6,24 @@
 #include "GameFramework/Character.h"
 #include "InputActionValue.h"
 #include "DrawDebugHelpers.h"
-#include "Utility/ISAGameplayTags.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Utility/ISALocomotionState.h"
 #include "Utility/ISASettings.h"
+#include "Utility/ISAMantleEvaluation.h"
+#include "Utility/ISAMantleProbe.h"
 #include "ISA.h"
 
 #include "ISACharacterBase.generated.h"
 
+class AISACharacterBase;
+struct FStreamableHandle;
+
+//Locomotion state change events, broadcast with the previous and the new value
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FISALocomotionModeChangedDelegate, AISACharacterBase& /*Character*/, EISALocomotionMode /*PreviousLocomotionMode*/, EISALocomotionMode /*NewLocomotionMode*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FISAStanceChangedDelegate, AISACharacterBase& /*Character*/, EISAStance /*PreviousStance*/, EISAStance /*NewStance*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FISAGaitChangedDelegate, AISACharacterBase& /*Character*/, EISAGait /*PreviousGait*/, EISAGait /*NewGait*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FISALocomotionActionChangedDelegate, AISACharacterBase& /*Character*/, EISALocomotionAction /*PreviousLocomotionAction*/, EISALocomotionAction /*NewLocomotionAction*/);
+
 UCLASS(config=Game)
 class AISACharacterBase : public ACharacter
 {
@@ -27,29 +39,25 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|ISA Character")
 	TObjectPtr<UMantleSettings> MantleSettings;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag DesiredStance { ISAStanceTags::Standing };
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag DesiredGait { ISAGaitTags::Walking };
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag LocomotionMode { ISALocomotionModeTags::Grounded };
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag LocomotionAction;
+	//Internal locomotion state, Blueprints and the debug display see it as tags through the getters below
+	FISALocomotionState LocomotionState;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag Stance { ISAStanceTags::Standing };
+	//LocomotionState packed into one word (see ISALocomotionState), replicated to simulated proxies
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedLocomotionState, Transient)
+	uint16 ReplicatedLocomotionState{0};
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tags|ISA Character", Transient)
-	FGameplayTag Gait { ISAGaitTags::Walking };
+	//Result of the last mantle evaluation, used by the mantle that is currently set up
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State|ISA Character", Transient)
+	FMantleResult MantleResult;
 
 	FTimerHandle BrakingFrictionFactorResetTimer;
 
 	UPROPERTY(EditDefaultsOnly,BlueprintReadWrite)
 	class UISAPushComponent* PushComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement)
+	class UMotionWarpingComponent* MotionWarping;
+
 private:
 	//Camera boom positioning the camera behind the character
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -61,9 +69,10 @@ private:
 
 public:
 	bool bPressedISAJump;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Force ISA Player")
+	//Set through SetForceGait, which refreshes the gait
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Force ISA Player")
 	bool bForceWalkRun;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Force ISA Player")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Force ISA Player")
 	bool bForceRunSprint;
 
 public:
@@ -82,44 +91,162 @@ public:
 	void SetDebugCommand();
 
 	virtual void PreRegisterAllComponents() override;
+	virtual void PostRegisterAllComponents() override;
+	virtual void OnRep_AttachmentReplication() override;
 protected:
 	// To add mapping context
 	virtual void BeginPlay() override;
 
-	void SetForceGait(bool bWalk_Run, bool bRunSprint);
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void NotifyControllerChanged() override;
 
 public:
+	UFUNCTION(BlueprintCallable, Category = "Force ISA Player")
+	void SetForceGait(bool bWalk_Run, bool bRunSprint);
+
 	//Returns CameraBoom subobject
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	//Returns FollowCamera subobject
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 	//Returns MovementComponent
 	FORCEINLINE class UISACharacterMovementComponent* GetISACharacterMovement() const { return ISACharacterMovementComponent; }
-	//Returns Ignored Character Params
-	FCollisionQueryParams GetIgnoreCharacterParams() const;
+	//Returns PushComponent subobject
+	FORCEINLINE class UISAPushComponent* GetPushComponent() const { return PushComponent; }
+	//Returns Ignored Character Params, rebuilt only after InvalidateIgnoreCharacterParams
+	const FCollisionQueryParams& GetIgnoreCharacterParams() const;
+	//Call when child actors or attachments change
+	void InvalidateIgnoreCharacterParams();
+
+private:
+	mutable FCollisionQueryParams IgnoreCharacterParams;
 
-	virtual void Tick(float DeltaTime) override;
+	mutable bool bIgnoreCharacterParamsDirty{true};
 
 public:
-	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode = 0) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-private:
-	void RefreshLocomotion(const float DeltaTime);
+public:
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode = 0) override;
 
 protected:
 	void MantleTrace();
-	
-	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
-	void SetupMantle();
-	
+
+	//Returns the probed result for the Async and Batched modes, nullptr if it is missing or too old
+	const FMantleResult* GetProbedMantleResult() const;
+
+private:
+	//Used when MantleSettings->ProbeMode is Async
+	FISAMantleProbe MantleProbe;
+
+	//Written by the UISAMantleSubsystem when MantleSettings->ProbeMode is Batched
+	FMantleResult BatchedMantleResult;
+
+	uint64 BatchedMantleResultFrame{0};
+
+public:
+	//True while grounded and walking into something, only then a mantle can start
+	bool ShouldProbeMantle() const;
+
+	FISAMantleQuery MakeMantleQuery() const;
+
+	void SetBatchedMantleResult(const FMantleResult& NewResult);
+
+	//Advances the async probe, called by the movement component after every movement update
+	void UpdateMantleProbe();
+
+private:
+	//Index into GeneralSettings->SignificanceSettings.Tiers, INDEX_NONE until the first significance update
+	int32 SignificanceTier{INDEX_NONE};
+
+	bool bSignificanceAllowsMantleProbe{true};
+
+	//The mesh setting for the tiers that keep the pose updating off screen
+	EVisibilityBasedAnimTickOption DefaultVisibilityBasedAnimTickOption{EVisibilityBasedAnimTickOption::AlwaysTickPose};
+
+	//Distance to the closest viewpoint from the last significance update
+	float SignificanceDistance{0.f};
+
+	//True when the mesh is registered with the animation budget allocator, which then owns its tick rate
+	bool bUsesAnimationBudget{false};
+
+	//The mesh setting, kept for the player's own character
+	bool bDefaultEnableUpdateRateOptimizations{false};
+
+public:
+	//Called by the UISASignificanceSubsystem with the distance to the closest viewpoint
+	void UpdateSignificance(float Distance);
+
+	int32 GetSignificanceTier() const;
+
+private:
+	void ApplySignificanceTier(const FISASignificanceTier& Tier);
+
+	void RegisterAnimationBudget();
+
+	void UnregisterAnimationBudget();
+
+	void RefreshAnimationBudget();
+
+	void RefreshUpdateRateOptimizations();
+
+	//Requested settings bundles, they stay loaded while the character exists
+	TMap<FName, TSharedPtr<FStreamableHandle>> AssetBundleHandles;
+
+	//Starts loading the bundle asynchronously, only the first request per bundle does anything
+	void PreloadAssetBundle(const UPrimaryDataAsset* Settings, FName Bundle);
+
+protected:	
+	//Sets the warp targets from MantleResult and plays the mantle montage
+	void StartMantle();
+
+	//Optional cosmetic hooks, the mantle itself is driven from C++
+	UFUNCTION(BlueprintImplementableEvent, Category = "ISA Character")
+	void OnMantleStarted(UAnimMontage* Montage);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "ISA Character")
+	void OnMantleEnded(bool bInterrupted);
+
+	//The client sends the mantle it found, the server only verifies it instead of searching again
+	UFUNCTION(Server, Reliable)
+	void ServerStartMantle(const FVector_NetQuantize10& StartPos, const FVector_NetQuantize10& MidPos, const FVector_NetQuantize10& EndPos,
+		EISAMantleType MantleType, bool bCanWarp);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRejectMantle();
+
+private:
+	void OnMantleMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+
+protected:	
 #pragma region GameplayTags
+//Change events, also broadcast on simulated proxies when the replicated state arrives
+public:
+	FISALocomotionModeChangedDelegate OnLocomotionModeChangedDelegate;
+
+	FISAStanceChangedDelegate OnStanceChangedDelegate;
+
+	FISAGaitChangedDelegate OnGaitChangedDelegate;
+
+	FISALocomotionActionChangedDelegate OnLocomotionActionChangedDelegate;
+
+//Replication
+private:
+	void RefreshReplicatedLocomotionState();
+
+	UFUNCTION()
+	void OnRep_ReplicatedLocomotionState();
+
 //Locomotion Mode
 private:
-	void SetLocomotionMode(const FGameplayTag& NewLocomotionMode);
+	void SetLocomotionMode(EISALocomotionMode NewLocomotionMode);
 
-	void NotifyLocomotionModeChanged(const FGameplayTag& PreviousLocomotionMode);
+	void NotifyLocomotionModeChanged(EISALocomotionMode PreviousLocomotionMode);
 
 public:
+	const FISALocomotionState& GetLocomotionState() const;
+
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetLocomotionMode() const;
 
 //Desired Stance
@@ -127,6 +254,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ISA Character", Meta = (AutoCreateRefTerm = "NewDesiredStance"))
 	void SetDesiredStance(const FGameplayTag& NewDesiredStance);
 
+	void SetDesiredStance(EISAStance NewDesiredStance);
+
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetDesiredStance() const;
 
 protected:
@@ -134,28 +264,32 @@ protected:
 
 //Stance
 private:
-	void SetStance(const FGameplayTag& NewStance);
+	void SetStance(EISAStance NewStance);
 
 public:
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetStance() const;
 
 //Desired Gait
 public:
-	void SetDesiredGait(const FGameplayTag& NewDesiredGait);
+	void SetDesiredGait(EISAGait NewDesiredGait);
 
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetDesiredGait() const;
 
 //Gait
 private:
-	void SetGait(const FGameplayTag& NewGait);
-
-	void RefreshGait();
+	void SetGait(EISAGait NewGait);
 
-	FGameplayTag CalculateMaxAllowedGait() const;
+	EISAGait CalculateMaxAllowedGait() const;
 
-	FGameplayTag CalculateActualGait(const FGameplayTag& MaxAllowedGait) const;
+	EISAGait CalculateActualGait(EISAGait MaxAllowedGait) const;
 
 public:
+	//Called by the movement component when speed, input, stance or desired gait changed
+	void RefreshGait();
+
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetGait() const;
 
 protected:
@@ -167,9 +301,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Als Character")
 	void SetLocomotionAction(const FGameplayTag& NewLocomotionAction);
 
+	void SetLocomotionAction(EISALocomotionAction NewLocomotionAction);
+
+	UFUNCTION(BlueprintPure, Category = "ISA Character")
 	const FGameplayTag& GetLocomotionAction() const;
 
-	void NotifyLocomotionActionChanged(const FGameplayTag& PreviousLocomotionAction);
+	void NotifyLocomotionActionChanged(EISALocomotionAction PreviousLocomotionAction);
 
 //Locomotion Actions
 public:
@@ -197,15 +334,19 @@ private:
 };
 
 #pragma region TagGettersImplementation
-inline const FGameplayTag& AISACharacterBase::GetDesiredStance() const { return DesiredStance; }
+inline int32 AISACharacterBase::GetSignificanceTier() const { return SignificanceTier; }
+
+inline const FISALocomotionState& AISACharacterBase::GetLocomotionState() const { return LocomotionState; }
+
+inline const FGameplayTag& AISACharacterBase::GetDesiredStance() const { return ISALocomotionState::ToTag(LocomotionState.DesiredStance); }
 
-inline const FGameplayTag& AISACharacterBase::GetDesiredGait() const { return DesiredGait; }
+inline const FGameplayTag& AISACharacterBase::GetDesiredGait() const { return ISALocomotionState::ToTag(LocomotionState.DesiredGait); }
 
-inline const FGameplayTag& AISACharacterBase::GetLocomotionMode() const { return LocomotionMode; }
+inline const FGameplayTag& AISACharacterBase::GetLocomotionMode() const { return ISALocomotionState::ToTag(LocomotionState.LocomotionMode); }
 
-inline const FGameplayTag& AISACharacterBase::GetLocomotionAction() const { return LocomotionAction; }
+inline const FGameplayTag& AISACharacterBase::GetLocomotionAction() const { return ISALocomotionState::ToTag(LocomotionState.LocomotionAction); }
 
-inline const FGameplayTag& AISACharacterBase::GetStance() const { return Stance; }
+inline const FGameplayTag& AISACharacterBase::GetStance() const { return ISALocomotionState::ToTag(LocomotionState.Stance); }
 
-inline const FGameplayTag& AISACharacterBase::GetGait() const { return Gait; }
+inline const FGameplayTag& AISACharacterBase::GetGait() const { return ISALocomotionState::ToTag(LocomotionState.Gait); }
 #pragma endregion
\ No newline at end of file
@@ -6,10 +6,13 @@
 #include "ISA.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "ISACharacterBase.h"
-#include "Utility/ISAGameplayTags.h"
+#include "Utility/ISALocomotionState.h"
 #include "Utility/ISASettings.h"
+#include "Utility/ISATrace.h"
 #include "ISACharacterMovementComponent.generated.h"
 
+class UISAPlaneProfile;
+
 UENUM(BlueprintType)
 enum ECustomMovementMode
 {
@@ -24,6 +27,65 @@ class ISA_API UISACharacterMovementComponent : public UCharacterMovementComponen
 {
 	GENERATED_BODY()
 
+#pragma region Network Prediction
+	//Saved move, stores the movement intent that is sent to the server and replayed on corrections
+	class FSavedMove_ISA : public FSavedMove_Character
+	{
+	public:
+		typedef FSavedMove_Character Super;
+
+		//Flags (crouch and slide intent travel in the engine's FLAG_WantsToCrouch, sprint in FLAG_Custom_0)
+		uint8 Saved_bWantsToSprint:1;
+
+		//Gait intent of the character, it picks the max walk speed and travels in FISACharacterNetworkMoveData
+		uint8 Saved_bForceWalkRun:1;
+
+		uint8 Saved_bForceRunSprint:1;
+
+		EISAGait Saved_DesiredGait{EISAGait::Walking};
+
+		FSavedMove_ISA();
+
+		virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+		virtual void Clear() override;
+		virtual uint8 GetCompressedFlags() const override;
+		virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+		virtual void PrepMoveFor(ACharacter* C) override;
+	};
+
+	//Makes the client allocate ISA saved moves instead of the default ones
+	class FNetworkPredictionData_Client_ISA : public FNetworkPredictionData_Client_Character
+	{
+	public:
+		FNetworkPredictionData_Client_ISA(const UCharacterMovementComponent& ClientMovement);
+
+		typedef FNetworkPredictionData_Client_Character Super;
+
+		virtual FSavedMovePtr AllocateNewMove() override;
+	};
+
+	//Move data sent to the server, adds the gait intent that does not fit in the compressed flags
+	struct FISACharacterNetworkMoveData : public FCharacterNetworkMoveData
+	{
+		typedef FCharacterNetworkMoveData Super;
+
+		//DesiredGait in the low two bits, then bForceWalkRun and bForceRunSprint
+		uint8 GaitIntent{0};
+
+		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+	};
+
+	struct FISACharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+	{
+		FISACharacterNetworkMoveDataContainer();
+
+		FISACharacterNetworkMoveData ISAMoveData[3];
+	};
+
+	FISACharacterNetworkMoveDataContainer ISANetworkMoveDataContainer;
+#pragma endregion
+
 
 #pragma region Parameters
 public:
@@ -46,23 +108,36 @@ private:
 	#pragma region Flags
 public:
 		bool bHasInput{false};
-		bool bCanSprint{false};
 private:
-		bool bWantsToSprint;
+		//Sprint intent, packed into the compressed flags so client and server agree on it
+		bool bWantsToSprint{false};
 
 		bool bHadAnimRootMotion;
-		bool bPrevWantsToCrouch;
+
+		//Set right before a slide is ended on purpose, traced by ExitSlide
+		EISASlideExitReason SlideExitReason{EISASlideExitReason::MovementModeChanged};
+
+		//Set when something the gait depends on changed, the gait is refreshed after the next movement update
+		bool bLocomotionDirty{true};
 	#pragma endregion
 
 protected:
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
-	FGameplayTag MaxAllowedGait{ISAGaitTags::Walking};
+	//Mirrors of the character state that pick the max walk speed
+	EISAGait MaxAllowedGait{EISAGait::Walking};
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State", Transient)
-	FGameplayTag Stance{ISAStanceTags::Standing};
+	EISAStance Stance{EISAStance::Standing};
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings|ISA Character")
 	TObjectPtr<UISASettings> Settings;
+
+	//Baked floor data of the current level, used instead of traces when the character is on the plane
+	UPROPERTY(Transient)
+	TObjectPtr<const UISAPlaneProfile> PlaneProfile;
+
+	//Where CurrentFloor was last found, lets the slide reuse it instead of tracing again
+	mutable FVector CurrentFloorLocation{ForceInit};
+
+	mutable bool bHasCurrentFloorLocation{false};
 	
 	
 #pragma endregion
@@ -72,6 +147,7 @@ public:
 	// Actor Component
 protected: 
 	virtual void InitializeComponent() override;
+	virtual void BeginPlay() override;
 	// Character Movement Component
 public:
 	virtual bool IsMovingOnGround() const override;
@@ -79,6 +155,11 @@ public:
 	virtual float GetMaxSpeed() const override;
 	virtual float GetMaxBrakingDeceleration() const override;
 
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
 public:
 	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
 	virtual void UpdateCharacterStateAfterMovement(float DeltaSeconds) override;
@@ -88,11 +169,19 @@ protected:
 	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 
+public:
+	//Both record where CurrentFloor was found, including the floor checks of the engine's walking code
+	virtual void FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult = nullptr) const override;
+	virtual void AdjustFloorHeight() override;
+
 	// Slide
 private:
 	void EnterSlide(EMovementMode PrevMode, ECustomMovementMode PrevCustomMode);
 	void ExitSlide();
 	bool CanSlide() const;
+	//True if CurrentFloor was found at the current location
+	bool IsCurrentFloorFresh() const;
+	void SetCurrentFloor(const FFindFloorResult& NewFloor);
 	void PhysSlide(float deltaTime, int32 Iterations);
 
 	// Helpers
@@ -104,11 +193,20 @@ private:
 	void SetupInputDirection(FVector NewInputDirection);
 
 public:
-	void SetStance(const FGameplayTag& NewStance);
+	void SetWantsToSprint(bool bNewWantsToSprint);
 
-	void SetMaxAllowedGait(const FGameplayTag& NewMaxAllowedGait);
+	bool WantsToSprint() const;
+
+	void SetStance(EISAStance NewStance);
+
+	void SetMaxAllowedGait(EISAGait NewMaxAllowedGait);
+
+	void MarkLocomotionDirty();
 
 private:
+	//Updates Speed and lets the character refresh its gait, only when an input of the gait changed
+	void RefreshLocomotion(bool bHadInput);
+
 	void RefreshMaxWalkSpeed();
 
 	void RefreshGaitSettings();
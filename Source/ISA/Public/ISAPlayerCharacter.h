@@ -13,6 +13,9 @@ class ISA_API AISAPlayerCharacter : public AISACharacterBase
 {
 	GENERATED_BODY()
 
+	//Drives characters through the input handlers
+	friend class FISAScriptedInput;
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input);
 	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
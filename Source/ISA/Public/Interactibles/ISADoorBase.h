@@ -34,4 +34,7 @@ public:
 
 	UFUNCTION(BlueprintNativeEvent)
 	void BPInteracted();
+
+	//For doors placed from code, added to the actor transform like the one edited in the level
+	void SetWarpTransform(const FTransform& NewWarpTransform);
 };
@@ -6,8 +6,10 @@
 #include "ISAPushableBase.h"
 #include "Components/ActorComponent.h"
 #include "Engine/EngineTypes.h"
+#include "Utility/ISALocomotionState.h"
 #include "ISAPushComponent.generated.h"
 
+class AISACharacterBase;
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class ISA_API UISAPushComponent : public UActorComponent
@@ -41,10 +43,17 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetPushableHeight() const;
 
+private:
+	void InvalidatePlayerQueryParams() const;
+
+	void OnLocomotionModeChanged(AISACharacterBase& Character, EISALocomotionMode PreviousLocomotionMode, EISALocomotionMode NewLocomotionMode);
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
@@ -36,6 +36,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual void OnInteracted(AISACharacterBase* Player) override;
 
+	//For crates placed from code, relative to the actor like the ones edited in the level
+	void SetPushTransforms(const TArray<FTransform>& NewPushTransforms);
+
 private:
 	void HandleInteraction(AISACharacterBase* Player);
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ISACsvStatsSubsystem.generated.h"
+
+class AISACharacterBase;
+
+//Writes the locomotion load into the ISA category of a CSV capture once per frame: registered characters per locomotion mode
+//and how many of them slide, mantle and push. The hot path timings and counters are written by ISAProfiling.
+//Only exists in builds with the CSV profiler, characters register themselves on BeginPlay.
+UCLASS()
+class ISA_API UISACsvStatsSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AISACharacterBase>> Characters;
+
+public:
+	void RegisterCharacter(AISACharacterBase* Character);
+
+	void UnregisterCharacter(AISACharacterBase* Character);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+};
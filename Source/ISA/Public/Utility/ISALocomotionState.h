@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Utility/ISAGameplayTags.h"
+
+//Compact mirrors of the locomotion tags, small enough to be packed into a single replicated word
+enum class EISALocomotionMode : uint8
+{
+	None,
+	Grounded,
+	InAir
+};
+
+enum class EISAStance : uint8
+{
+	Standing,
+	Crouching
+};
+
+enum class EISAGait : uint8
+{
+	Walking,
+	Running,
+	Sprinting
+};
+
+enum class EISALocomotionAction : uint8
+{
+	None,
+	Mantling,
+	Sliding
+};
+
+//Everything the locomotion logic decides on, 6 bytes per character
+struct FISALocomotionState
+{
+	EISALocomotionMode LocomotionMode{EISALocomotionMode::Grounded};
+	EISAStance DesiredStance{EISAStance::Standing};
+	EISAStance Stance{EISAStance::Standing};
+	EISAGait DesiredGait{EISAGait::Walking};
+	EISAGait Gait{EISAGait::Walking};
+	EISALocomotionAction LocomotionAction{EISALocomotionAction::None};
+};
+
+namespace ISALocomotionState
+{
+	constexpr int32 StanceCount{static_cast<int32>(EISAStance::Crouching) + 1};
+	constexpr int32 GaitCount{static_cast<int32>(EISAGait::Sprinting) + 1};
+
+	//Tag -> Enum, unknown tags map to the first entry
+	ISA_API EISALocomotionMode ToLocomotionMode(const FGameplayTag& Tag);
+	ISA_API EISAStance ToStance(const FGameplayTag& Tag);
+	ISA_API EISAGait ToGait(const FGameplayTag& Tag);
+	ISA_API EISALocomotionAction ToLocomotionAction(const FGameplayTag& Tag);
+
+	//Enum -> Tag
+	ISA_API const FGameplayTag& ToTag(EISALocomotionMode LocomotionMode);
+	ISA_API const FGameplayTag& ToTag(EISAStance Stance);
+	ISA_API const FGameplayTag& ToTag(EISAGait Gait);
+	ISA_API const FGameplayTag& ToTag(EISALocomotionAction LocomotionAction);
+
+	//Bit layout of the packed state word (10 bits used)
+	constexpr uint16 LocomotionModeShift{0};		//2 bits
+	constexpr uint16 DesiredStanceShift{2};		//1 bit
+	constexpr uint16 StanceShift{3};				//1 bit
+	constexpr uint16 DesiredGaitShift{4};		//2 bits
+	constexpr uint16 GaitShift{6};				//2 bits
+	constexpr uint16 LocomotionActionShift{8};	//2 bits
+
+	ISA_API uint16 Pack(const FISALocomotionState& State);
+	ISA_API FISALocomotionState Unpack(uint16 PackedState);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionShape.h"
+#include "Utility/MantleSettings.h"
+
+class UWorld;
+
+//Everything a mantle evaluation needs from the character, gathered on the game thread
+struct ISA_API FISAMantleQuery
+{
+	FVector Location{ForceInit};
+
+	FVector Forward{ForceInit};
+
+	float CapsuleHalfHeight{0.f};
+
+	float CapsuleRadius{0.f};
+
+	const AActor* IgnoredActor{nullptr};
+
+	const UMantleSettings* Settings{nullptr};
+};
+
+//One of the three sweeps of a mantle evaluation
+struct ISA_API FISAMantleSweep
+{
+	FVector Start{ForceInit};
+
+	FVector End{ForceInit};
+
+	FCollisionShape Shape;
+};
+
+//A mantle is classified with three sweeps:
+//Forward, a thin capsule covering the mantleable height range finds the obstacle.
+//Top, a sphere swept down just behind the front face finds the obstacle height.
+//Landing, a capsule sized sphere swept down behind the obstacle finds its depth and the landing point.
+namespace ISAMantle
+{
+	ISA_API FCollisionObjectQueryParams MakeObjectQueryParams(const UMantleSettings& Settings);
+
+	ISA_API FCollisionQueryParams MakeQueryParams(const FISAMantleQuery& Query);
+
+	ISA_API FISAMantleSweep MakeForwardSweep(const FISAMantleQuery& Query);
+
+	ISA_API FISAMantleSweep MakeTopSweep(const FISAMantleQuery& Query, const FHitResult& ForwardHit);
+
+	//Fills MantleType and the start and mid positions, returns false if the obstacle can't be mantled
+	ISA_API bool ClassifyTop(const FISAMantleQuery& Query, const FHitResult& TopHit, FMantleResult& OutResult);
+
+	ISA_API FISAMantleSweep MakeLandingSweep(const FISAMantleQuery& Query, const FHitResult& ForwardHit, const FHitResult& TopHit);
+
+	//Fills the end position and bCanMantle
+	ISA_API void ClassifyLanding(const FISAMantleQuery& Query, const FHitResult& TopHit, const FHitResult& LandingHit, FMantleResult& OutResult);
+
+	//Only draws on the game thread, calls from workers are ignored
+	ISA_API void DrawSweep(const UWorld& World, const FISAMantleSweep& Sweep, bool bHit, EDrawDebugTrace::Type DrawDebugType);
+
+	//Checks a mantle proposed by a client against the server state instead of searching again.
+	//Plausibility checks first, then one sweep for clearance over the obstacle and one for the landing floor.
+	ISA_API bool ValidateMantle(const UWorld& World, const FISAMantleQuery& Query, const FMantleResult& Proposal);
+
+	//Runs the three sweeps synchronously.
+	//Only reads the world and the query, so it can run on any thread that holds the physics scene read lock.
+	ISA_API void EvaluateMantle(const UWorld& World, const FISAMantleQuery& Query, FMantleResult& OutResult);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+#include "Utility/ISAMantleEvaluation.h"
+
+class AISACharacterBase;
+
+//Runs the three mantle sweeps as async sweeps while the character moves on the ground.
+//Every stage issues a single sweep and is consumed the frame after, so a character never costs more than one sweep per frame.
+//A sweep that was not consumed in time restarts the probe.
+class ISA_API FISAMantleProbe
+{
+public:
+	//Collects the sweep issued last frame and issues the next one
+	void Tick(AISACharacterBase& Character);
+
+	//Drops the pending sweep and the last result
+	void Reset();
+
+	//Returns the last result, or nullptr if there is none younger than MaxAgeFrames
+	const FMantleResult* GetResult(uint64 MaxAgeFrames) const;
+
+private:
+	enum class EStage : uint8
+	{
+		Idle,
+		Forward,
+		Top,
+		Landing
+	};
+
+	void Issue(UWorld& World, const FISAMantleSweep& Sweep);
+
+	void Evaluate(UWorld& World, const FHitResult& Hit);
+
+	void Resolve();
+
+private:
+	EStage Stage{EStage::Idle};
+
+	FTraceHandle Handle;
+
+	//GFrameCounter when Handle was issued
+	uint64 IssueFrame{0};
+
+	FISAMantleSweep PendingSweep;
+
+	//Gathered when the probe starts, all stages use the same query
+	FISAMantleQuery Query;
+
+	FHitResult ForwardHit;
+
+	FHitResult TopHit;
+
+	FMantleResult PendingResult;
+
+	FMantleResult Result;
+
+	//GFrameCounter when Result was resolved
+	uint64 ResultFrame{0};
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utility/ISAMantleEvaluation.h"
+#include "ISAMantleSubsystem.generated.h"
+
+class AISACharacterBase;
+
+//Evaluates the mantle candidates of every registered character in one parallel pass per frame.
+//Characters register themselves when their MantleSettings use the Batched probe mode.
+UCLASS()
+class ISA_API UISAMantleSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AISACharacterBase>> Characters;
+
+	//Scratch buffers, kept around so the per frame pass doesn't allocate
+	TArray<AISACharacterBase*> QueryOwners;
+
+	TArray<FISAMantleQuery> Queries;
+
+	TArray<FMantleResult> Results;
+
+public:
+	void RegisterCharacter(AISACharacterBase* Character);
+
+	void UnregisterCharacter(AISACharacterBase* Character);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+//LLM tags of the ISA module, shown under ISA in stat LLM and the LLM CSV when running with -llm.
+//Budgets for them are set on UISAMemoryBudgetSubsystem
+LLM_DECLARE_TAG_API(ISA, ISA_API);
+
+//Characters, their movement, camera and push components
+LLM_DECLARE_TAG_API(ISA_Character, ISA_API);
+
+//Anim instances, linked layers and the pose database
+LLM_DECLARE_TAG_API(ISA_Animation, ISA_API);
+
+//The settings data assets
+LLM_DECLARE_TAG_API(ISA_Settings, ISA_API);
+
+//Montage bundle requests, the montages themselves are tagged by the loader
+LLM_DECLARE_TAG_API(ISA_Montages, ISA_API);
+
+//Pushables and doors
+LLM_DECLARE_TAG_API(ISA_Interactables, ISA_API);
+
+//Buffers reused by the per frame queries
+LLM_DECLARE_TAG_API(ISA_Scratch, ISA_API);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+namespace ISAMemory
+{
+	//Bytes held under all the ISA tags as of the last LLM stats update
+	ISA_API int64 GetTrackedBytes();
+}
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "ISAMemoryBudgetSubsystem.generated.h"
+
+USTRUCT()
+struct ISA_API FISAMemoryBudget
+{
+	GENERATED_BODY()
+
+	//Character, Animation, Settings, Montages, Interactables or Scratch, see ISAMemory.h
+	UPROPERTY(Config)
+	FName Tag;
+
+	UPROPERTY(Config, Meta = (ClampMin = 0, ForceUnits = "MB"))
+	float MaxMegabytes{0.f};
+};
+
+//Warns when an ISA LLM tag goes over its budget, once per crossing. Only runs with -llm.
+//Budgets are per platform, e.g. in DefaultGame.ini or a platform Game.ini:
+//[/Script/ISA.ISAMemoryBudgetSubsystem]
+//+Budgets=(Tag="Character",MaxMegabytes=64)
+UCLASS(Config = Game)
+class ISA_API UISAMemoryBudgetSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	UPROPERTY(Config)
+	TArray<FISAMemoryBudget> Budgets;
+
+	UPROPERTY(Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float CheckInterval{1.f};
+
+	//Budgets that were over at the last check, by index
+	TBitArray<> OverBudgets;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+private:
+	bool CheckBudgets(float DeltaTime);
+};
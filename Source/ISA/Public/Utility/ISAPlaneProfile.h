@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ISAPlaneProfile.generated.h"
+
+namespace ISAPlaneProfile
+{
+	//The profile is baked with the collision the runtime floor traces use, so both see the same floors
+	inline const FName CollisionProfileName{TEXT("BlockAll")};
+}
+
+//One floor layer at one coordinate along the gameplay plane, 12 bytes
+USTRUCT()
+struct ISA_API FISAPlaneProfileSample
+{
+	GENERATED_BODY()
+
+	//Distance along the plane axis from the profile origin
+	UPROPERTY()
+	float Coordinate{0.f};
+
+	UPROPERTY()
+	float FloorZ{0.f};
+
+	//Floor normal in the plane (along the axis and up), quantized to -127..127
+	UPROPERTY()
+	int8 NormalAlong{0};
+
+	UPROPERTY()
+	int8 NormalUp{127};
+};
+
+//Result of a floor lookup
+struct ISA_API FISAPlaneFloor
+{
+	float FloorZ{0.f};
+
+	FVector Normal{FVector::UpVector};
+};
+
+//Floor heights and slope normals of the static geometry along the gameplay plane of one level.
+//Baked offline by UISABakePlaneProfileCommandlet, floor lookups are binary searches over a flat array.
+//Movable actors such as pushables are not part of it, anything that has to see them still traces.
+UCLASS(BlueprintType)
+class ISA_API UISAPlaneProfile : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	//Where the plane starts, coordinates are measured from here along Axis
+	UPROPERTY(VisibleAnywhere, Category = "Profile")
+	FVector Origin{ForceInit};
+
+	//Horizontal direction the gameplay happens along
+	UPROPERTY(VisibleAnywhere, Category = "Profile")
+	FVector Axis{FVector::ForwardVector};
+
+	//Queries further away from the plane than this are not answered by the profile
+	UPROPERTY(VisibleAnywhere, Category = "Profile", Meta = (ForceUnits = "cm"))
+	float PlaneTolerance{50.f};
+
+	UPROPERTY(VisibleAnywhere, Category = "Profile", Meta = (ForceUnits = "cm"))
+	float SampleSpacing{10.f};
+
+	//Sorted by coordinate, then by floor height
+	UPROPERTY()
+	TArray<FISAPlaneProfileSample> Samples;
+
+public:
+	float ToCoordinate(const FVector& Location) const;
+
+	//True if Location is close enough to the plane and inside the baked range
+	bool IsValidAt(const FVector& Location) const;
+
+	//Finds the highest floor below Location that is at most MaxDrop lower
+	bool FindFloor(const FVector& Location, float MaxDrop, FISAPlaneFloor& OutFloor) const;
+};
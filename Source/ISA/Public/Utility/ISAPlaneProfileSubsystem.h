@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ISAPlaneProfileSubsystem.generated.h"
+
+class UISAPlaneProfile;
+
+//Loads the baked plane profile of the current level, if there is one.
+//Profiles are found by name: /Game/ISA/PlaneProfiles/<MapName>_PlaneProfile
+UCLASS()
+class ISA_API UISAPlaneProfileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UISAPlaneProfile> Profile;
+
+public:
+	static FString GetProfilePackageName(const FString& MapName);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	const UISAPlaneProfile* GetProfile() const;
+};
+
+inline const UISAPlaneProfile* UISAPlaneProfileSubsystem::GetProfile() const { return Profile; }
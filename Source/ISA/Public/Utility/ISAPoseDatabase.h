@@ -0,0 +1,142 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ISAPoseDatabase.generated.h"
+
+class UAnimSequence;
+
+namespace ISAPoseSearch
+{
+	//Root velocity (2) and the root position at every trajectory time (2 each), in the root motion space of the clips, which is mesh space
+	constexpr int32 FeatureCount{8};
+
+	constexpr int32 TrajectorySampleCount{3};
+
+	constexpr float TrajectoryTimes[TrajectorySampleCount]{0.2f, 0.4f, 0.6f};
+}
+
+//Where a pose comes from
+USTRUCT()
+struct ISA_API FISAPoseSource
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 SequenceIndex{0};
+
+	UPROPERTY()
+	float Time{0.f};
+};
+
+//Poses [Start, Start + Count) belong to one cluster
+USTRUCT()
+struct ISA_API FISAPoseCluster
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Start{0};
+
+	UPROPERTY()
+	int32 Count{0};
+
+	//Largest distance from the center to one of its poses, lets the search skip clusters that can't contain a better pose
+	UPROPERTY()
+	float Radius{0.f};
+};
+
+struct ISA_API FISAPoseSearchResult
+{
+	//One of the database's sequences
+	UAnimSequence* Sequence{nullptr};
+
+	float Time{0.f};
+
+	int32 PoseIndex{INDEX_NONE};
+
+	float Cost{TNumericLimits<float>::Max()};
+};
+
+//Motion matching pose database built offline from locomotion clips.
+//Features are stored as one contiguous float block per pose (8 floats, two vector registers), grouped by cluster,
+//so a query only scans the closest clusters and never more than MaxPosesPerQuery poses.
+UCLASS(BlueprintType)
+class ISA_API UISAPoseDatabase : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Source")
+	TArray<TObjectPtr<UAnimSequence>> Sequences;
+
+	UPROPERTY(EditAnywhere, Category = "Source", Meta = (ClampMin = 0.01, ForceUnits = "s"))
+	float SampleInterval{1.f / 30.f};
+
+	UPROPERTY(EditAnywhere, Category = "Weights", Meta = (ClampMin = 0))
+	float VelocityWeight{1.f};
+
+	UPROPERTY(EditAnywhere, Category = "Weights", Meta = (ClampMin = 0))
+	float TrajectoryWeight{1.f};
+
+	UPROPERTY(EditAnywhere, Category = "Index", Meta = (ClampMin = 1, ClampMax = 256))
+	int32 ClusterCount{32};
+
+	UPROPERTY(EditAnywhere, Category = "Index", Meta = (ClampMin = 1))
+	int32 ClusterIterations{8};
+
+	//Hard limit on the poses one query compares against
+	UPROPERTY(EditAnywhere, Category = "Search", Meta = (ClampMin = 1))
+	int32 MaxPosesPerQuery{256};
+
+private:
+	//Normalization and weights folded into one factor per feature
+	UPROPERTY()
+	TArray<float> FeatureScales;
+
+	//FeatureCount floats per pose, in cluster order
+	UPROPERTY()
+	TArray<float> Features;
+
+	UPROPERTY()
+	TArray<FISAPoseSource> Sources;
+
+	//FeatureCount floats per cluster
+	UPROPERTY()
+	TArray<float> ClusterCenters;
+
+	UPROPERTY()
+	TArray<FISAPoseCluster> Clusters;
+
+	//Pose index for every sample of every sequence, in sequence and time order, used to find the pose that is playing
+	UPROPERTY()
+	TArray<int32> SequencePoses;
+
+	//First entry in SequencePoses for every sequence, plus one entry past the end
+	UPROPERTY()
+	TArray<int32> SequencePoseStarts;
+
+public:
+	virtual void Serialize(FArchive& Ar) override;
+
+	int32 GetPoseCount() const;
+
+	//Builds the query features from the mesh space velocity and acceleration
+	static void MakeQuery(const FVector& LocalVelocity, const FVector& LocalAcceleration, float MaxSpeed, float (&OutQuery)[ISAPoseSearch::FeatureCount]);
+
+	//Finds the pose closest to Query. The pose that is playing (Sequence at Time) wins when it is within ContinuingCostBias of the best
+	bool Search(const float (&Query)[ISAPoseSearch::FeatureCount], const UAnimSequence* Sequence, float Time, float ContinuingCostBias, FISAPoseSearchResult& OutResult) const;
+
+#if WITH_EDITOR
+	//Samples the sequences, normalizes the features and builds the cluster index
+	UFUNCTION(CallInEditor, Category = "Index")
+	void BuildIndex();
+#endif
+
+private:
+	int32 FindPose(const UAnimSequence* Sequence, float Time) const;
+
+	float ComputeCost(const float* NormalizedQuery, int32 PoseIndex) const;
+};
+
+inline int32 UISAPoseDatabase::GetPoseCount() const { return Sources.Num(); }
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+#include <atomic>
+
+//Timers and counters around the ISA hot paths, read by the benchmark and scenario commandlets, shown in stat ISA and Insights
+//and written to the ISA category of a CSV capture. Compiled out in Shipping
+#define ISA_WITH_PROFILING !UE_BUILD_SHIPPING
+
+DECLARE_STATS_GROUP(TEXT("ISA"), STATGROUP_ISA, STATCAT_Advanced);
+
+//One cycle stat per timer and one per frame counter per counter, named after them
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PhysSlide"), STAT_ISA_PhysSlide, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanSlide"), STAT_ISA_CanSlide, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshGait"), STAT_ISA_RefreshGait, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("MantleTrace"), STAT_ISA_MantleTrace, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PushTick"), STAT_ISA_PushTick, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interact"), STAT_ISA_Interact, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimUpdate"), STAT_ISA_AnimUpdate, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimThreadSafeUpdate"), STAT_ISA_AnimThreadSafeUpdate, STATGROUP_ISA, ISA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PoseSearch"), STAT_ISA_PoseSearch, STATGROUP_ISA, ISA_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Physics Queries"), STAT_ISA_PhysicsQueries, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slide Queries"), STAT_ISA_SlideQueries, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mantle Queries"), STAT_ISA_MantleQueries, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interact Queries"), STAT_ISA_InteractQueries, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Push Queries"), STAT_ISA_PushQueries, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Movement Updates"), STAT_ISA_MovementUpdates, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slide Iterations"), STAT_ISA_SlideIterations, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mantle Probes"), STAT_ISA_MantleProbes, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interactable Candidates"), STAT_ISA_InteractableCandidates, STATGROUP_ISA, ISA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Searched Poses"), STAT_ISA_SearchedPoses, STATGROUP_ISA, ISA_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ISA_API, ISA);
+
+namespace ISAProfiling
+{
+	enum class ETimer : uint8
+	{
+		PhysSlide,
+		CanSlide,
+		RefreshGait,
+		MantleTrace,
+		//UISAPushComponent::TickComponent
+		PushTick,
+		//AISAPlayerCharacter::Input_OnInteract
+		Interact,
+		AnimUpdate,
+		AnimThreadSafeUpdate,
+		//UISAPoseDatabase::Search
+		PoseSearch,
+		Count
+	};
+
+	enum class ECounter : uint8
+	{
+		//Traces, sweeps and overlaps issued by ISA code, in total and by the code that issued them
+		PhysicsQueries,
+		SlideQueries,
+		MantleQueries,
+		InteractQueries,
+		PushQueries,
+		//Moves performed by the ISA movement component, replays included
+		MovementUpdates,
+		//Move iterations of PhysSlide
+		SlideIterations,
+		//Mantle queries evaluated, on jump, in the background or to validate
+		MantleProbes,
+		//Actors found by the interact overlap
+		InteractableCandidates,
+		//Poses compared by the motion matching searches, bounded by MaxPosesPerQuery per search
+		SearchedPoses,
+		Count
+	};
+
+	constexpr int32 TimerCount{static_cast<int32>(ETimer::Count)};
+	constexpr int32 CounterCount{static_cast<int32>(ECounter::Count)};
+
+	//Names used in the reports
+	ISA_API const TCHAR* ToString(ETimer Timer);
+	ISA_API const TCHAR* ToString(ECounter Counter);
+
+#if ISA_WITH_PROFILING
+	//Off unless something reads the results, a disabled timer or counter only costs the check
+	extern ISA_API std::atomic<bool> bEnabled;
+
+	//Accumulated since the last reset, written from the game and the worker threads
+	extern ISA_API std::atomic<uint64> TimerCycles[TimerCount];
+	extern ISA_API std::atomic<uint64> CounterValues[CounterCount];
+
+	ISA_API void Reset();
+
+	ISA_API double GetTimerSeconds(ETimer Timer);
+
+	ISA_API uint64 GetCounter(ECounter Counter);
+
+	inline void IncrementCounter(ECounter Counter, uint64 Amount = 1)
+	{
+		if (bEnabled.load(std::memory_order_relaxed))
+		{
+			CounterValues[static_cast<int32>(Counter)].fetch_add(Amount, std::memory_order_relaxed);
+		}
+	}
+
+	class FScopedTimer
+	{
+	public:
+		explicit FScopedTimer(ETimer InTimer)
+			: Timer{InTimer},
+			  StartCycles{bEnabled.load(std::memory_order_relaxed) ? FPlatformTime::Cycles64() : 0}
+		{
+		}
+
+		~FScopedTimer()
+		{
+			if (StartCycles != 0)
+			{
+				TimerCycles[static_cast<int32>(Timer)].fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+			}
+		}
+
+		UE_NONCOPYABLE(FScopedTimer);
+
+	private:
+		ETimer Timer;
+
+		uint64 StartCycles;
+	};
+#endif
+}
+
+//Each timer also shows up as its cycle stat, as a CPU profiler scope named ISA_<Timer> and as a CSV timing stat,
+//each counter as its DWORD stat and as a CSV stat accumulated over the frame
+#if ISA_WITH_PROFILING
+#define ISA_SCOPED_TIMER(Timer) \
+	const ISAProfiling::FScopedTimer PREPROCESSOR_JOIN(ISAScopedTimer, __LINE__){ISAProfiling::ETimer::Timer}; \
+	SCOPE_CYCLE_COUNTER(STAT_ISA_##Timer); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(ISA_##Timer); \
+	CSV_SCOPED_TIMING_STAT(ISA, Timer)
+#define ISA_INC_COUNTER_BY(Counter, Amount) \
+	do \
+	{ \
+		ISAProfiling::IncrementCounter(ISAProfiling::ECounter::Counter, Amount); \
+		INC_DWORD_STAT_BY(STAT_ISA_##Counter, Amount); \
+		CSV_CUSTOM_STAT(ISA, Counter, static_cast<int32>(Amount), ECsvCustomStatOp::Accumulate); \
+	} while (false)
+#define ISA_INC_COUNTER(Counter) ISA_INC_COUNTER_BY(Counter, 1)
+#else
+#define ISA_SCOPED_TIMER(Timer)
+#define ISA_INC_COUNTER_BY(Counter, Amount)
+#define ISA_INC_COUNTER(Counter)
+#endif
+
+//Source is Slide, Mantle, Interact or Push
+#define ISA_INC_PHYSICS_QUERY(Source) \
+	do \
+	{ \
+		ISA_INC_COUNTER(PhysicsQueries); \
+		ISA_INC_COUNTER(Source##Queries); \
+	} while (false)
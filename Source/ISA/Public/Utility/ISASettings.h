@@ -1,24 +1,106 @@
 #pragma once
 
 #include "Engine/DataAsset.h"
-#include "Utility/ISAGameplayTags.h"
+#include "Utility/ISALocomotionState.h"
 #include "Animation/AnimMontage.h"
 #include "ISASettings.generated.h"
 
 class UMantleSettings;
 
+//Asset manager bundles of the settings assets, loaded asynchronously by the characters before they are needed
+namespace ISAAssetBundles
+{
+	inline const FName Slide{TEXT("Slide")};
+	inline const FName Mantle{TEXT("Mantle")};
+}
+
 //All the variables used for Sliding
 USTRUCT(BlueprintType)
 struct ISA_API FISASlideSettings
 {
 	GENERATED_BODY()
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS")
-	TObjectPtr<UAnimMontage> Montage{nullptr};
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS", Meta = (AssetBundles = "Slide"))
+	TSoftObjectPtr<UAnimMontage> Montage;
+};
+
+//How much of the character is updated at one significance tier
+USTRUCT(BlueprintType)
+struct ISA_API FISASignificanceTier
+{
+	GENERATED_BODY()
+
+	//Characters further away from every viewpoint than this fall to the next tier, ignored for the last tier
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float MaxDistance{0.f};
+
+	//0 ticks every frame. Only applies to characters simulated on this machine, not to proxies of other machines
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 0, ForceUnits = "s"))
+	float MovementTickInterval{0.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 1))
+	int32 MaxSimulationIterations{8};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 0, ForceUnits = "s"))
+	float AnimationTickInterval{0.f};
+
+	//Keeps the pose updating while the mesh is off screen
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	bool bTickPoseWhenNotRendered{true};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 0, ForceUnits = "s"))
+	float ComponentTickInterval{0.f};
+
+	//Ignored when the movement ticks at an interval, the probe has to run every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	bool bProbeMantle{true};
+};
+
+//Opt-in animation throttling for the character meshes
+USTRUCT(BlueprintType)
+struct ISA_API FISAAnimationBudgetSettings
+{
+	GENERATED_BODY()
+
+	//Registers the meshes with the animation budget allocator, which reduces their update rate to stay within BudgetInMs
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Animation Budget")
+	bool bUseAnimationBudget{false};
+
+	//Game thread time for all the budgeted meshes together
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Animation Budget", Meta = (ClampMin = 0, ForceUnits = "ms", EditCondition = "bUseAnimationBudget"))
+	float BudgetInMs{1.f};
+
+	//Distance at which the budget significance of a mesh is halved
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Animation Budget", Meta = (ClampMin = 1, ForceUnits = "cm", EditCondition = "bUseAnimationBudget"))
+	float HalfSignificanceDistance{1000.f};
+
+	//Level of detail based update rate optimization with interpolation, used when the budget is off. Never for the player's own character
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Animation Budget")
+	bool bEnableUpdateRateOptimizations{false};
+};
+
+//All the variables used for the significance tiers
+USTRUCT(BlueprintType)
+struct ISA_API FISASignificanceSettings
+{
+	GENERATED_BODY()
+
+	//Ordered from the most to the least significant
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance")
+	TArray<FISASignificanceTier> Tiers;
+
+	//How far past a tier boundary a character has to move before it changes tier, avoids popping on the boundary
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Significance", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float HysteresisDistance{200.f};
+
+	FISASignificanceSettings();
+
+	//Picks the tier for Distance, moving at most as far as the hysteresis allows away from CurrentTier
+	int32 SelectTier(float Distance, int32 CurrentTier) const;
 };
 
 //General Settings
 UCLASS(Blueprintable, BlueprintType)
-class ISA_API UISASettings : public UDataAsset
+class ISA_API UISASettings : public UPrimaryDataAsset
 {
 	GENERATED_BODY()
 
@@ -26,16 +108,16 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float TestValue{50.f};
 	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float WalkSpeed{175.0f};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float RunSpeed{375.0f};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float SprintSpeed{650.0f};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ISA", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float CrouchSpeed{150.0f};
 	
 	static constexpr auto HasInputBrakingFrictionFactor{ 0.5f };
@@ -43,35 +125,34 @@ public:
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings")
 	FISASlideSettings SlideSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings")
+	FISASignificanceSettings SignificanceSettings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings")
+	FISAAnimationBudgetSettings AnimationBudgetSettings;
+
+private:
+	//Max walk speed per stance and gait, baked from the speeds above so lookups are a single index
+	float SpeedTable[ISALocomotionState::StanceCount][ISALocomotionState::GaitCount]{};
+
 public:
-	float GetSpeedForGait(const FGameplayTag& Gait, const FGameplayTag& Stance) const;
-	
+	virtual void PostInitProperties() override;
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	float GetSpeedForGait(EISAGait Gait, EISAStance Stance) const;
+
+private:
+	void BakeSpeedTable();
 };
 
 // Helper Functions
-inline float UISASettings::GetSpeedForGait(const FGameplayTag& Gait, const FGameplayTag& Stance) const
+inline float UISASettings::GetSpeedForGait(EISAGait Gait, EISAStance Stance) const
 {
-	if (Stance == ISAStanceTags::Standing)
-	{
-		if (Gait == ISAGaitTags::Walking)
-		{
-			return WalkSpeed;
-		}
-
-		if (Gait == ISAGaitTags::Running)
-		{
-			return RunSpeed;
-		}
-
-		if (Gait == ISAGaitTags::Sprinting)
-		{
-			return SprintSpeed;
-		}
-	}
-	else if (Stance == ISAStanceTags::Crouching)
-	{
-		return  CrouchSpeed;
-	}
-	
-	return 0.0f;
-}
\ No newline at end of file
+	return SpeedTable[static_cast<uint8>(Stance)][static_cast<uint8>(Gait)];
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ISASignificanceSubsystem.generated.h"
+
+class AISACharacterBase;
+
+//Feeds the viewpoints of all players, remote ones included on a server, to the significance manager and passes the result on to the registered characters,
+//which pick their tier from UISASettings::SignificanceSettings.
+UCLASS()
+class ISA_API UISASignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+private:
+	static const FName SignificanceTag;
+
+	//Scratch buffer, kept around so the per frame update doesn't allocate
+	TArray<FTransform> Viewpoints;
+
+public:
+	void RegisterCharacter(AISACharacterBase* Character);
+
+	void UnregisterCharacter(AISACharacterBase* Character);
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ObjectTrace.h"
+#include "Trace/Trace.h"
+#include "Utility/ISALocomotionState.h"
+
+class AActor;
+struct FMantleResult;
+
+//Locomotion events on the ISA trace channel, keyed by the object ids the Rewind Debugger uses. Enable with -trace=default,object,isa.
+//Follows the object trace, so it is compiled out in Shipping
+#define ISA_TRACE_ENABLED OBJECT_TRACE_ENABLED
+
+//Why a slide ended, the mode change is the fallback for everything that is not picked out
+enum class EISASlideExitReason : uint8
+{
+	MovementModeChanged,
+	//Crouch released
+	StoodUp,
+	//PhysSlide found the slide can't continue, too slow, not crouching or no floor
+	CanSlideFailed
+};
+
+#if ISA_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(ISAChannel, ISA_API)
+
+namespace ISATrace
+{
+	ISA_API void OutputLocomotionTransition(const AActor& Actor, EISALocomotionMode PreviousLocomotionMode, EISALocomotionMode NewLocomotionMode);
+	ISA_API void OutputLocomotionTransition(const AActor& Actor, EISAStance PreviousStance, EISAStance NewStance);
+	ISA_API void OutputLocomotionTransition(const AActor& Actor, EISAGait PreviousGait, EISAGait NewGait);
+	ISA_API void OutputLocomotionTransition(const AActor& Actor, EISALocomotionAction PreviousLocomotionAction, EISALocomotionAction NewLocomotionAction);
+
+	ISA_API void OutputSlideEnter(const AActor& Actor, float Speed);
+	ISA_API void OutputSlideExit(const AActor& Actor, EISASlideExitReason Reason, float Speed);
+
+	//bProbed when the result came from the background probe instead of a trace on jump
+	ISA_API void OutputMantleResult(const AActor& Actor, const FMantleResult& Result, bool bProbed);
+
+	ISA_API void OutputPush(const AActor& Actor, const AActor* Pushable, bool bBegin);
+}
+
+//Only checks the channel while it is off, the arguments are not evaluated
+#define ISA_TRACE(Event, ...) \
+	do \
+	{ \
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ISAChannel)) \
+		{ \
+			ISATrace::Output##Event(__VA_ARGS__); \
+		} \
+	} while (false)
+#else
+#define ISA_TRACE(Event, ...)
+#endif
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Animation/AnimMontage.h"
 #include "MantleSettings.generated.h"
 
 //All the variables for Mantling
@@ -15,42 +17,132 @@ enum class EISAMantleType
 	MantleHigh
 };
 
-UCLASS(Blueprintable, BlueprintType)
-class ISA_API UMantleSettings : public UDataAsset
+//Output of a mantle evaluation, owned by the character that was evaluated
+USTRUCT(BlueprintType)
+struct ISA_API FMantleResult
 {
 	GENERATED_BODY()
 
-public:
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle Settings");
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
 	EISAMantleType MantleType{EISAMantleType::NoMantle};
-	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle Settings");
-	FVector VaultStartPos;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle Settings");
-	FVector VaultMidPos;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
+	FVector VaultStartPos{ForceInit};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
+	FVector VaultMidPos{ForceInit};
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Mantle Settings");
-	FVector VaultEndPos;
-	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mantle Settings");
-	bool bCanWarp;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
+	FVector VaultEndPos{ForceInit};
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Mantle Settings");
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
+	bool bCanWarp{true};
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Mantle")
 	bool bCanMantle{false};
+};
 
+//When the mantle traces are done
+UENUM(BlueprintType)
+enum class EISAMantleProbeMode : uint8
+{
+	//All traces run synchronously on the jump press
+	OnJump,
+	//Traces run asynchronously while grounded and moving, the jump press only reads the last result
+	Async,
+	//Evaluated together with all other batched characters by the UISAMantleSubsystem
+	Batched
+};
+
+//Read-only configuration, can be shared by any number of characters. Results live in FMantleResult on the character.
+UCLASS(Blueprintable, BlueprintType)
+class ISA_API UMantleSettings : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mantle Settings");
 	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float ForwardTraceLength{180.f};
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
-	float TraceForwardStart{30.f};
-
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings", Meta = (ClampMin = 0, ForceUnits = "cm/s"))
 	float TraceRadius{5.f};
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS")
-	TObjectPtr<UAnimMontage> Montage{nullptr};
+	//Obstacles lower than this are left to the step up of the movement component
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Classification", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float MinMantleHeight{45.f};
+
+	//Obstacles up to this height are a MantleLow
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Classification", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float LowMantleMaxHeight{125.f};
+
+	//Obstacles up to this height are a MantleHigh, anything higher can't be mantled
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Classification", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float HighMantleMaxHeight{225.f};
+
+	//Obstacles deeper than this are climbed onto instead of vaulted over
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Classification", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float MaxVaultDepth{100.f};
+
+	//How far the character may drop behind a vaulted obstacle
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Classification", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float MaxLandingDrop{1000.f};
+
+	//How far a client proposed mantle may be off from what the server sees before it is rejected
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Validation", Meta = (ClampMin = 0, ForceUnits = "cm"))
+	float ValidationTolerance{50.f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Probing")
+	EISAMantleProbeMode ProbeMode{EISAMantleProbeMode::OnJump};
+
+	//Results older than this are ignored on the jump press
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Probing", Meta = (ClampMin = 1, EditCondition = "ProbeMode != EISAMantleProbeMode::OnJump"))
+	int32 MaxProbeResultAge{8};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debug")
+	TEnumAsByte<EDrawDebugTrace::Type> DebugTraceType{EDrawDebugTrace::None};
+
+	//Warp target names used by the mantle montages
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Warping")
+	FName StartWarpTargetName{TEXT("VaultStart")};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Warping")
+	FName MidWarpTargetName{TEXT("VaultMiddle")};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Warping")
+	FName EndWarpTargetName{TEXT("VaultLand")};
+
+	//Played when there is no montage for the mantle type
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS", Meta = (AssetBundles = "Mantle"))
+	TSoftObjectPtr<UAnimMontage> Montage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS", Meta = (AssetBundles = "Mantle"))
+	TSoftObjectPtr<UAnimMontage> LowMantleMontage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS", Meta = (AssetBundles = "Mantle"))
+	TSoftObjectPtr<UAnimMontage> HighMantleMontage;
+
+public:
+	virtual void Serialize(FArchive& Ar) override;
+
+	//Never loads, returns nullptr while the Mantle bundle is still loading
+	UAnimMontage* GetMontageForMantleType(EISAMantleType MantleType) const;
 };
+
+// Helper Functions
+inline UAnimMontage* UMantleSettings::GetMontageForMantleType(EISAMantleType MantleType) const
+{
+	if (MantleType == EISAMantleType::MantleLow && !LowMantleMontage.IsNull())
+	{
+		return LowMantleMontage.Get();
+	}
+
+	if (MantleType == EISAMantleType::MantleHigh && !HighMantleMontage.IsNull())
+	{
+		return HighMantleMontage.Get();
+	}
+
+	return Montage.Get();
+}